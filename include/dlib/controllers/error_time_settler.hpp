@@ -81,8 +81,8 @@ public:
         this->time_below_threshold = au::ZERO;
     }
 protected:
-    bool is_settling;
-    au::Quantity<au::Seconds, double> time_below_threshold;
+    bool is_settling = false;
+    au::Quantity<au::Seconds, double> time_below_threshold = au::ZERO;
 
     const au::Quantity<Units, double> error_threshold;
     const au::Quantity<au::Seconds, double> settle_time;
@@ -0,0 +1,112 @@
+#pragma once
+#include <cstdint>
+#include "dlib/controllers/pid.hpp"
+
+namespace dlib {
+
+// gain_search.hpp
+
+struct GainSearchConfig {
+    /** The gains to start searching from, usually from a RelayAutotuner */
+    PidGains initial_gains{};
+    /** The fraction of each gain to step by at the start of the search */
+    double initial_step = 0.25;
+    /** The step fraction at which the search is considered converged */
+    double minimum_step = 0.02;
+    /** The maximum number of candidates to evaluate */
+    int32_t max_trials = 24;
+    /** If the integral gain should be searched, the drivetrain controllers leave it at 0 */
+    bool search_ki = false;
+};
+
+/**
+ * @brief A coordinate pattern search over Pid gains
+ *
+ * The search is hardware agnostic, the caller runs each candidate on the robot
+ * and reports a cost (lower is better) such as settle time plus overshoot.
+ */
+class GainSearch {
+public:
+    GainSearch(GainSearchConfig config);
+
+    /**
+     * @brief Reset the search back to the initial gains
+     *
+     */
+    void reset();
+
+    /**
+     * @brief Get the next gains to evaluate
+     *
+     * @return the candidate gains
+     *
+     * @b Example
+     * @code {.cpp}
+     *
+     * // Start the search from the current angular gains
+     * dlib::GainSearchConfig config {{30, 0, 1.6}};
+     * dlib::GainSearch search(config);
+     *
+     * while (!search.is_done()) {
+     *     auto gains = search.next_candidate();
+     *     angular_pid.set_gains(gains);
+     *
+     *     // run a move and measure it
+     *     search.report(settle_time + overshoot);
+     * }
+     *
+     * dlib::PidGains best = search.get_best_gains();
+     * @endcode
+    */
+    PidGains next_candidate();
+
+    /**
+     * @brief Report the cost of the last candidate returned by next_candidate
+     *
+     * @param cost the cost of the candidate, lower is better
+     */
+    void report(double cost);
+
+    /**
+     * @brief Check if the search has converged or run out of trials
+     *
+     * @return if the search is done
+     */
+    bool is_done() const;
+
+    /**
+     * @brief Get the best gains found so far
+     *
+     * @return the best gains
+     */
+    PidGains get_best_gains() const;
+
+    /**
+     * @brief Get the cost of the best gains found so far
+     *
+     * @return the best cost
+     */
+    double get_best_cost() const;
+
+protected:
+    void advance();
+
+    const GainSearchConfig config;
+
+    PidGains best_gains;
+    PidGains candidate;
+    double best_cost;
+    double step;
+
+    // the gain being perturbed: 0 = kp, 1 = ki, 2 = kd
+    int32_t coordinate;
+    // the direction of the current perturbation (+1 or -1)
+    int32_t direction;
+    // the number of coordinates tried in a row without any improvement
+    int32_t failed_coordinates;
+    int32_t trials;
+
+    bool has_baseline;
+};
+
+}
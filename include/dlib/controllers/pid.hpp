@@ -134,7 +134,11 @@ public:
      * @endcode
     */
     PidGains get_gains() const {
-        return m_gains;
+        return {
+            m_gains.kp.in(decltype(au::Volts{} / BaseUnits{}){}),
+            m_gains.ki.in(decltype(au::Volts{} / au::TimeIntegral<BaseUnits>{}){}),
+            m_gains.kd.in(decltype(au::Volts{} / au::TimeDerivative<BaseUnits>{}){})
+        };
     }
 
     /**
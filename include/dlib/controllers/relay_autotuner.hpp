@@ -0,0 +1,224 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+#include "au/au.hpp"
+#include "dlib/controllers/pid.hpp"
+
+namespace dlib {
+
+// relay_autotuner.hpp
+
+/**
+ * @brief The tuning rule used to turn an ultimate gain & period into Pid gains
+ *
+ */
+enum class ZieglerNicholsRule {
+    /** The classic Ziegler-Nichols Pid rule, fast with noticeable overshoot */
+    ClassicPid,
+    /** A conservative Pid rule that trades rise time for little to no overshoot */
+    NoOvershoot,
+    /** A Pd rule, matching how the drivetrain controllers are usually tuned (no integral) */
+    Pd
+};
+
+/**
+ * @brief The measured critical point of a system
+ *
+ */
+struct RelayAutotuneResult {
+    /** The ultimate gain in volts per base unit (volts per meter, volts per radian) */
+    double ultimate_gain = 0;
+    /** The period of the sustained oscillation at the ultimate gain */
+    au::Quantity<au::Seconds, double> ultimate_period = au::ZERO;
+};
+
+template<typename Units>
+struct RelayAutotunerConfig {
+    /** The voltage the relay switches between (+/-) */
+    au::Quantity<au::Volts, double> relay_voltage = au::volts(6);
+    /** The error band the relay will not switch inside of, rejects sensor noise */
+    au::Quantity<Units, double> hysteresis = au::ZERO;
+    /** The number of full oscillations to average over (the first cycle is always discarded) */
+    int32_t cycles = 4;
+    /** The time after which the autotuner gives up */
+    au::Quantity<au::Seconds, double> timeout = au::seconds(10);
+};
+
+template<typename Units>
+class RelayAutotuner {
+public:
+    RelayAutotuner(RelayAutotunerConfig<Units> config) : config(config) {
+        this->reset();
+    }
+
+    /**
+     * @brief Reset all of the autotuner state
+     *
+     */
+    void reset() {
+        output_sign = 0;
+        elapsed_time = au::ZERO;
+        last_rising_time = au::ZERO;
+        period_sum = au::ZERO;
+        amplitude_sum = 0;
+        cycle_max = 0;
+        cycle_min = 0;
+        rising_edges = 0;
+        measured_cycles = 0;
+    }
+
+    /**
+     * @brief Calculate the relay voltage
+     *
+     * @param error distance from setpoint
+     * @param period the interval at which the autotuner is updated
+     * @return the voltage to send to your mechanism
+     *
+     * @b Example
+     * @code {.cpp}
+     *
+     * // Construct a relay autotuner
+     * dlib::RelayAutotuner<Degrees> tuner({volts(6), degrees(0.5)});
+     *
+     * while (!tuner.is_done()) {
+     *     auto error = dlib::angular_error(target, imu.get_rotation());
+     *     chassis.turn_voltage(-tuner.update(error, milli(seconds)(20)));
+     *     pros::delay(20);
+     * }
+     *
+     * dlib::PidGains gains = tuner.ziegler_nichols(dlib::ZieglerNicholsRule::Pd);
+     *
+     * @endcode
+    */
+    au::Quantity<au::Volts, double> update(
+        au::Quantity<Units, double> error,
+        au::Quantity<au::Seconds, double> period
+    ) {
+        elapsed_time += period;
+
+        if (this->is_done()) {
+            return au::ZERO;
+        }
+
+        double reading = error.in(BaseUnits{});
+        cycle_max = std::max(cycle_max, reading);
+        cycle_min = std::min(cycle_min, reading);
+
+        // the relay only switches once the error leaves the hysteresis band
+        if (error > config.hysteresis && output_sign != 1) {
+            output_sign = 1;
+            this->on_rising_edge();
+        } else if (error < -config.hysteresis && output_sign != -1) {
+            output_sign = -1;
+        } else if (output_sign == 0) {
+            // the error starts inside the band, kick the system to start oscillating
+            output_sign = 1;
+        }
+
+        return config.relay_voltage * static_cast<double>(output_sign);
+    }
+
+    /**
+     * @brief Check if the autotuner has finished
+     *
+     * @return if enough cycles were measured or the autotuner timed out
+     */
+    bool is_done() const {
+        return measured_cycles >= config.cycles || elapsed_time >= config.timeout;
+    }
+
+    /**
+     * @brief Check if the autotuner measured a usable critical point
+     *
+     * @return if at least one full oscillation was measured
+     */
+    bool has_result() const {
+        return measured_cycles > 0 && amplitude_sum > 0;
+    }
+
+    /**
+     * @brief Get the measured ultimate gain & period
+     *
+     * @return the averaged critical point, or zero if nothing was measured
+     */
+    RelayAutotuneResult get_result() const {
+        RelayAutotuneResult result{};
+
+        if (!this->has_result()) {
+            return result;
+        }
+
+        double amplitude = amplitude_sum / measured_cycles;
+        double hysteresis = config.hysteresis.in(BaseUnits{});
+
+        // describing function of a relay with hysteresis: Ku = 4d / (pi * sqrt(a^2 - e^2))
+        double effective_amplitude = std::sqrt(std::max(amplitude * amplitude - hysteresis * hysteresis, 1e-12));
+
+        result.ultimate_gain = 4 * config.relay_voltage.in(au::volts) / (M_PI * effective_amplitude);
+        result.ultimate_period = period_sum / static_cast<double>(measured_cycles);
+
+        return result;
+    }
+
+    /**
+     * @brief Propose Pid gains from the measured critical point
+     *
+     * @param rule the tuning rule to apply
+     * @return the proposed gains, or zero gains if nothing was measured
+     */
+    PidGains ziegler_nichols(ZieglerNicholsRule rule = ZieglerNicholsRule::ClassicPid) const {
+        auto result = this->get_result();
+
+        double ku = result.ultimate_gain;
+        double tu = result.ultimate_period.in(au::seconds);
+
+        if (ku == 0 || tu == 0) {
+            return {};
+        }
+
+        switch (rule) {
+            case ZieglerNicholsRule::ClassicPid:
+                return {0.6 * ku, 1.2 * ku / tu, 0.075 * ku * tu};
+            case ZieglerNicholsRule::NoOvershoot:
+                return {0.2 * ku, 0.4 * ku / tu, 0.066 * ku * tu};
+            case ZieglerNicholsRule::Pd:
+                return {0.8 * ku, 0, 0.1 * ku * tu};
+            default:
+                return {};
+        }
+    }
+
+protected:
+    using BaseUnits = au::UnitImpl<au::detail::DimT<Units>>;
+
+    void on_rising_edge() {
+        rising_edges++;
+
+        // the first edge starts the measurement, the first full cycle is transient
+        if (rising_edges > 2) {
+            period_sum += elapsed_time - last_rising_time;
+            amplitude_sum += (cycle_max - cycle_min) / 2;
+            measured_cycles++;
+        }
+
+        last_rising_time = elapsed_time;
+        cycle_max = 0;
+        cycle_min = 0;
+    }
+
+    const RelayAutotunerConfig<Units> config;
+
+    int8_t output_sign;
+    au::Quantity<au::Seconds, double> elapsed_time;
+    au::Quantity<au::Seconds, double> last_rising_time;
+    au::Quantity<au::Seconds, double> period_sum;
+
+    double amplitude_sum;
+    double cycle_max;
+    double cycle_min;
+
+    int32_t rising_edges;
+    int32_t measured_cycles;
+};
+
+}
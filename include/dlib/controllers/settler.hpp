@@ -0,0 +1,178 @@
+#pragma once
+#include "au/au.hpp"
+
+// settler.hpp
+
+namespace dlib {
+
+/**
+ * @brief Why a motion has (or hasn't) finished
+ *
+ */
+enum class SettleState {
+    /** The motion is still running */
+    Running,
+    /** The error and derivative stayed within their thresholds for the settle time */
+    Settled,
+    /** The motion ran longer than the timeout */
+    TimedOut,
+    /** The mechanism stopped moving while still outside the error threshold */
+    Stalled
+};
+
+template<typename Units>
+struct SettlerConfig {
+    /** The maximum error at which we can settle */
+    au::Quantity<Units, double> error_threshold;
+    /** The maximum derivative at which we can settle */
+    au::Quantity<au::TimeDerivative<Units>, double> derivative_threshold;
+    /** The time the error and derivative must stay within their thresholds to settle */
+    au::Quantity<au::Seconds, double> settle_time = au::ZERO;
+    /** The maximum time a motion can run for, zero disables the timeout */
+    au::Quantity<au::Seconds, double> timeout = au::seconds(5);
+    /** The velocity below which the mechanism is considered stopped, zero disables stall detection */
+    au::Quantity<au::TimeDerivative<Units>, double> stall_velocity = au::ZERO;
+    /** The time the mechanism must be stopped outside of the error threshold to be stalled */
+    au::Quantity<au::Seconds, double> stall_time = au::milli(au::seconds)(250.0);
+};
+
+template<typename Units>
+class Settler {
+public:
+    Settler(SettlerConfig<Units> config) : config(config) {
+        this->reset();
+    }
+
+    /**
+     * @brief Update the settler with the latest controller state
+     *
+     * @param error distance from setpoint
+     * @param derivative rate of change of the error
+     * @param velocity the measured velocity of the mechanism, used for stall detection
+     * @param period time since the last update
+     * @return the state of the motion
+     *
+     * @b Example
+     * @code {.cpp}
+     *
+     * // Construct a Settler
+     * dlib::Settler<Meters> settler({
+     *     inches(1),                   // error threshold
+     *     meters_per_second(0.1),      // derivative threshold
+     *     milli(seconds)(60.0),        // time within the thresholds to settle
+     *     seconds(3),                  // timeout
+     *     meters_per_second(0.02)      // stall velocity
+     * });
+     *
+     * settler.reset();
+     *
+     * while (settler.update(error, pid.get_derivative(), velocity, seconds(0.02)) == dlib::SettleState::Running) {
+     *     // run the controller
+     * }
+     *
+     * @endcode
+    */
+    SettleState update(
+        au::Quantity<Units, double> error,
+        au::Quantity<au::TimeDerivative<Units>, double> derivative,
+        au::Quantity<au::TimeDerivative<Units>, double> velocity,
+        au::Quantity<au::Seconds, double> period
+    ) {
+        if (this->state != SettleState::Running) {
+            return this->state;
+        }
+
+        this->elapsed_time += period;
+
+        bool within_error = au::abs(error) <= config.error_threshold;
+        bool within_derivative = au::abs(derivative) <= config.derivative_threshold;
+
+        // error & derivative must stay within their thresholds for the whole settle time
+        if (within_error && within_derivative) {
+            this->time_within_threshold += period;
+        } else {
+            this->time_within_threshold = au::ZERO;
+        }
+
+        // a mechanism that isn't moving while far from the target is blocked
+        if (config.stall_velocity > au::ZERO && !within_error && au::abs(velocity) <= config.stall_velocity) {
+            this->time_stalled += period;
+        } else {
+            this->time_stalled = au::ZERO;
+        }
+
+        if (within_error && within_derivative && this->time_within_threshold >= config.settle_time) {
+            this->state = SettleState::Settled;
+        } else if (config.stall_velocity > au::ZERO && this->time_stalled >= config.stall_time) {
+            this->state = SettleState::Stalled;
+        } else if (config.timeout > au::ZERO && this->elapsed_time >= config.timeout) {
+            this->state = SettleState::TimedOut;
+        }
+
+        return this->state;
+    }
+
+    /**
+     * @brief Update the settler, using the derivative of the error as the velocity
+     *
+     * @param error distance from setpoint
+     * @param derivative rate of change of the error
+     * @param period time since the last update
+     * @return the state of the motion
+     */
+    SettleState update(
+        au::Quantity<Units, double> error,
+        au::Quantity<au::TimeDerivative<Units>, double> derivative,
+        au::Quantity<au::Seconds, double> period
+    ) {
+        return this->update(error, derivative, derivative, period);
+    }
+
+    /**
+     * @brief Check if the motion has finished for any reason
+     *
+     * @return if the settler is no longer running
+     */
+    bool is_done() const {
+        return this->state != SettleState::Running;
+    }
+
+    /**
+     * @brief Get the state of the motion
+     *
+     * @return the last state returned by update
+     */
+    SettleState get_state() const {
+        return this->state;
+    }
+
+    /**
+     * @brief Get the time since the settler was reset
+     *
+     * @return the elapsed time
+     */
+    au::Quantity<au::Seconds, double> get_elapsed_time() const {
+        return this->elapsed_time;
+    }
+
+    /**
+     * @brief Reset all of the settler state
+     *
+     */
+    void reset() {
+        this->state = SettleState::Running;
+        this->elapsed_time = au::ZERO;
+        this->time_within_threshold = au::ZERO;
+        this->time_stalled = au::ZERO;
+    }
+
+protected:
+    const SettlerConfig<Units> config;
+
+    SettleState state = SettleState::Running;
+    au::Quantity<au::Seconds, double> elapsed_time = au::ZERO;
+    au::Quantity<au::Seconds, double> time_within_threshold = au::ZERO;
+    au::Quantity<au::Seconds, double> time_stalled = au::ZERO;
+};
+
+}
@@ -0,0 +1,102 @@
+#pragma once
+#include <algorithm>
+#include "au/au.hpp"
+#include "dlib/controllers/feedforward.hpp"
+#include "dlib/controllers/pid.hpp"
+
+namespace dlib {
+
+// velocity_controller.hpp
+
+struct VelocityControllerConfig {
+    /** The feedforward gains, converts the target velocity & acceleration into a base voltage */
+    FeedforwardGains feedforward{};
+    /** The velocity Pid, corrects the difference between the target and measured velocity */
+    PidConfig pid{};
+};
+
+/**
+ * @brief An inner velocity loop: Feedforward plus a Pid on velocity error
+ *
+ * Used as the inner loop of a cascaded controller, where an outer position or
+ * profile loop produces the target velocity.
+ */
+template<typename Units>
+class VelocityController {
+public:
+    VelocityController(VelocityControllerConfig config) :
+        feedforward(config.feedforward),
+        pid(config.pid),
+        max_voltage(config.pid.max_voltage) {
+
+    }
+
+    /**
+     * @brief Reset all of the controller state
+     *
+     */
+    void reset() {
+        pid.reset();
+    }
+
+    /**
+     * @brief Calculate the voltage needed to track a velocity
+     *
+     * @param target_velocity the target velocity
+     * @param target_acceleration the target acceleration
+     * @param measured_velocity the measured velocity of the mechanism
+     * @param period the interval at which the controller is updated
+     * @return the voltage to send to your mechanism
+     *
+     * @b Example
+     * @code {.cpp}
+     *
+     * // Construct a VelocityController
+     * dlib::VelocityController<Meters> controller({
+     *     {1.3, 6.09, 1.25},  // feedforward gains
+     *     {{2, 0, 0}}         // velocity pid gains
+     * });
+     *
+     * Quantity<Volts, double> voltage = controller.update(
+     *     meters_per_second(1),
+     *     ZERO,
+     *     chassis.left_motors_velocity(),
+     *     milli(seconds)(10)
+     * );
+     *
+     * @endcode
+    */
+    au::Quantity<au::Volts, double> update(
+        au::Quantity<au::TimeDerivative<Units>, double> target_velocity,
+        au::Quantity<au::Time2ndDerivative<Units>, double> target_acceleration,
+        au::Quantity<au::TimeDerivative<Units>, double> measured_velocity,
+        au::Quantity<au::Seconds, double> period
+    ) {
+        au::Quantity<au::Volts, double> feedforward_voltage = au::ZERO;
+
+        // ks has no sign at zero velocity, so don't push against static friction when asked to stop
+        if (target_velocity != au::ZERO) {
+            feedforward_voltage = feedforward.calculate(target_velocity, target_acceleration);
+        }
+
+        auto feedback_voltage = pid.update(target_velocity - measured_velocity, period);
+
+        return std::clamp(feedforward_voltage + feedback_voltage, -max_voltage, max_voltage);
+    }
+
+    /**
+     * @brief Get the velocity error from the last update
+     *
+     * @return the velocity error
+     */
+    au::Quantity<au::TimeDerivative<Units>, double> get_error() const {
+        return pid.get_error();
+    }
+
+protected:
+    Feedforward<Units> feedforward;
+    Pid<au::TimeDerivative<Units>> pid;
+    const au::Quantity<au::Volts, double> max_voltage;
+};
+
+}
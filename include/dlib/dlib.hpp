@@ -4,6 +4,10 @@
 #include "dlib/controllers/pid.hpp"
 #include "dlib/controllers/error_derivative_settler.hpp"
 #include "dlib/controllers/error_time_settler.hpp"
+#include "dlib/controllers/gain_search.hpp"
+#include "dlib/controllers/relay_autotuner.hpp"
+#include "dlib/controllers/settler.hpp"
+#include "dlib/controllers/velocity_controller.hpp"
 
 #include "dlib/hardware/chassis.hpp"
 #include "dlib/hardware/imu.hpp"
@@ -11,9 +15,22 @@
 #include "dlib/hardware/motor.hpp"
 #include "dlib/hardware/rotation.hpp"
 
+#include "dlib/kinematics/differential_drive_kinematics.hpp"
 #include "dlib/kinematics/odometry.hpp"
 
+#include "dlib/telemetry/cobs.hpp"
+#include "dlib/telemetry/sd_logger.hpp"
+#include "dlib/telemetry/telemetry_channel.hpp"
+#include "dlib/telemetry/telemetry_protocol.hpp"
+#include "dlib/telemetry/telemetry_record.hpp"
+#include "dlib/telemetry/telemetry_stream.hpp"
+
 #include "dlib/trajectories/profile_setpoint.hpp"
 #include "dlib/trajectories/trapezoid_profile.hpp"
 
-#include "dlib/utilities/error_calculation.hpp"
\ No newline at end of file
+#include "dlib/utilities/desaturate.hpp"
+#include "dlib/utilities/error_calculation.hpp"
+#include "dlib/utilities/log.hpp"
+#include "dlib/utilities/motion_result.hpp"
+#include "dlib/utilities/ring_buffer.hpp"
+#include "dlib/utilities/thermal_limiter.hpp"
\ No newline at end of file
@@ -1,11 +1,43 @@
 #pragma once
 #include "motor_group.hpp"
+#include "dlib/kinematics/differential_drive_kinematics.hpp"
+#include "dlib/utilities/desaturate.hpp"
 #include "pros/abstract_motor.hpp"
 #include <initializer_list>
 namespace dlib {
 
 // chassis.hpp
 
+/**
+ * @brief How a joystick axis is shaped before it becomes a voltage
+ * 
+ */
+struct DriveCurveConfig {
+    /** Joystick values (out of 127) at or below this are treated as zero */
+    double deadband = 5;
+    /** Blend between a linear (0) and cubic (1) response, higher values give finer control near center */
+    double expo = 0;
+};
+
+/**
+ * @brief The input shaping used by the driver control modes
+ * 
+ */
+struct DriverControlConfig {
+    DriveCurveConfig throttle_curve{};
+    DriveCurveConfig turn_curve{};
+
+    /** The fraction of the turn input that is used */
+    double turn_scale = 1;
+    /** Scales the right side output, compensates for a drivetrain that pulls to one side */
+    double right_side_scale = 1;
+
+    /** The fastest each side's voltage can change, zero disables slew limiting */
+    au::Quantity<decltype(au::Volts{} / au::Seconds{}), double> slew_rate = au::ZERO;
+    /** The voltage a full joystick input maps to */
+    au::Quantity<au::Volts, double> max_voltage = au::volts(12);
+};
+
 struct ChassisConfig {
     MotorGroupConfig left_motors;
     MotorGroupConfig right_motors;
@@ -15,13 +47,18 @@ struct ChassisConfig {
     au::Quantity<au::Rpm, double> base_rpm;
     au::Quantity<au::Rpm, double> total_rpm;
     au::Quantity<au::Meters, double> wheel_diameter;
+    au::Quantity<au::Meters, double> track_width;
+
+    DriverControlConfig driver_control;
 
     ChassisConfig(
         MotorGroupConfig left_motors_config,
         MotorGroupConfig right_motors_config,
         pros::MotorGearset drive_gearset,
         au::Quantity<au::Rpm, double> total_rpm,
-        au::Quantity<au::Meters, double> wheel_diameter
+        au::Quantity<au::Meters, double> wheel_diameter,
+        au::Quantity<au::Meters, double> track_width,
+        DriverControlConfig driver_control = {}
     );
 };
 
@@ -38,7 +75,8 @@ public:
 	 *  {1, 2, 3},	// left motor ports
 	 *  {4, 5, 6},	// right motor ports
 	 *  rpm(450),	// the drivebase rpm
-	 *  inches(3.25)	// the drivebase wheel diameter
+	 *  inches(3.25),	// the drivebase wheel diameter
+	 *  inches(11.5)	// the distance between the left & right wheels
 	 * });
      * 
      * // Construct a chassis
@@ -111,6 +149,27 @@ public:
      * @param voltage the voltage to send to the motors
      */
     void turn_voltage(const au::Quantity<au::Volts, double> voltage);
+
+    /**
+     * @brief Move each side of the Chassis with its own voltage
+     * 
+     * If either side is above 12V both sides are scaled down together to keep their ratio
+     * 
+     * @param left_voltage the voltage to send to the left motors
+     * @param right_voltage the voltage to send to the right motors
+     */
+    void tank_voltage(const au::Quantity<au::Volts, double> left_voltage, const au::Quantity<au::Volts, double> right_voltage);
+
+    /**
+     * @brief Move and turn the Chassis at the same time with controller voltages
+     * 
+     * Uses the same sign convention as move_voltage & turn_voltage, and desaturates
+     * so the turn is preserved when the linear voltage is near the limit
+     * 
+     * @param linear_voltage the forward voltage
+     * @param turn_voltage the turn voltage, positive drives the left side forward
+     */
+    void arcade_voltage(const au::Quantity<au::Volts, double> linear_voltage, const au::Quantity<au::Volts, double> turn_voltage);
     
     /**
      * @brief Turn the Chassis
@@ -141,6 +200,40 @@ public:
     */
     void arcade(const int32_t power, const int32_t turn);
 
+    /**
+     * @brief Drive each side of the Chassis with its own joystick input
+     * 
+     * @param left the left joystick input value
+     * @param right the right joystick input value
+     * 
+     * @b Example
+     * @code {.cpp}
+     * chassis.tank(master.get_analog(ANALOG_LEFT_Y), master.get_analog(ANALOG_RIGHT_Y));
+     * @endcode
+     */
+    void tank(const int32_t left, const int32_t right);
+
+    /**
+     * @brief Drive the Chassis with curvature (cheesy) drive
+     * 
+     * The turn input controls the curvature of the path instead of the turn rate,
+     * so the robot turns the same radius at any speed.
+     * 
+     * @param throttle the forward joystick input value
+     * @param turn the turn joystick input value
+     * @param quick_turn turn in place like arcade, used when stopped
+     * 
+     * @b Example
+     * @code {.cpp}
+     * chassis.curvature(
+     *     master.get_analog(ANALOG_LEFT_Y), 
+     *     master.get_analog(ANALOG_RIGHT_X), 
+     *     master.get_digital(DIGITAL_L1)
+     * );
+     * @endcode
+     */
+    void curvature(const int32_t throttle, const int32_t turn, const bool quick_turn = false);
+
     /**
      * @brief Brake the Chassis
      * 
@@ -205,6 +298,20 @@ public:
      */
     au::Quantity<au::MetersPerSecond, double> forward_motor_velocity();
 
+    /**
+     * @brief Get the angular velocity of the Chassis from the difference in side velocities
+     * 
+     * @return the angular velocity of the Chassis, positive when the right side is faster
+     */
+    au::Quantity<au::RadiansPerSecond, double> angular_velocity();
+
+    /**
+     * @brief Get the linear & angular velocity of the Chassis
+     * 
+     * @return the measured chassis speeds
+     */
+    ChassisSpeeds chassis_speeds();
+
     Chassis(ChassisConfig config);
 
     dlib::MotorGroup left_motors;
@@ -215,6 +322,28 @@ public:
     au::Quantity<au::Rpm, double> base_rpm;
     au::Quantity<au::Rpm, double> total_rpm;
     au::Quantity<au::Meters, double> wheel_diameter;
+
+    DifferentialDriveKinematics kinematics;
+
+    DriverControlConfig driver_control;
+
+protected:
+    /**
+     * @brief Apply the deadband & expo curve to a joystick input
+     * 
+     * @return the shaped input in [-1, 1]
+     */
+    double shape_input(const int32_t input, const DriveCurveConfig curve) const;
+
+    /**
+     * @brief Slew limit each side towards a target voltage, then send it to the motors
+     * 
+     */
+    void drive_slewed(const au::Quantity<au::Volts, double> left_voltage, const au::Quantity<au::Volts, double> right_voltage);
+
+    au::Quantity<au::Volts, double> left_output = au::ZERO;
+    au::Quantity<au::Volts, double> right_output = au::ZERO;
+    uint32_t last_drive_time = 0;
 };
 
 }
\ No newline at end of file
@@ -1,22 +1,45 @@
 #pragma once
 
 #include "pros/imu.hpp"
+#include "pros/rtos.hpp"
 #include "au/au.hpp"
+#include <array>
+#include <cstdint>
+#include <vector>
 
 // imu.hpp
 
 namespace dlib {
 
 struct ImuConfig {
-    int8_t port;
+    std::vector<int8_t> ports;
     double scalar;
+    au::Quantity<au::Degrees, double> fusion_tolerance;
 
     ImuConfig(int8_t port, double scalar = 1);
+    ImuConfig(std::vector<int8_t> ports, double scalar = 1, au::Quantity<au::Degrees, double> fusion_tolerance = au::degrees(2.0));
 };
 
 class Imu {
 protected:
     double scalar;
+    au::Quantity<au::Degrees, double> fusion_tolerance;
+
+    // the measured drift rate of each imu, subtracted from its rotation since drift_start_time
+    std::vector<au::Quantity<au::DegreesPerSecond, double>> drift_rates;
+    uint32_t drift_start_time = 0;
+
+    // the compensation applied to each imu before drift_start_time, kept when the rate is remeasured
+    std::vector<au::Quantity<au::Degrees, double>> drift_offsets;
+
+    // returned if every imu fails, and used to pick between two imus that disagree
+    au::Quantity<au::Degrees, double> last_rotation = au::ZERO;
+
+    uint32_t calibration_start_time = 0;
+    bool calibration_started = false;
+    bool calibrated = false;
+
+    pros::Mutex mutex{};
 public:
     /**
      * @brief Initialize the Imu
@@ -35,10 +58,77 @@ public:
      * @endcode
     */
     void initialize();
+
+    /**
+     * @brief Start calibrating every Imu without waiting for it to finish
+     * 
+     * Calibration takes about two seconds, start it first so the rest of
+     * initialize() can run in the meantime. get_rotation holds its last value
+     * (zero) until calibration finishes.
+     * 
+     * @b Example
+     * @code {.cpp}
+     * void initialize() {
+     *     imu.start_calibration();
+     * 
+     *     // build the gui, tare motors, etc.
+     * 
+     *     imu.wait_until_calibrated();
+     * }
+     * @endcode
+    */
+    void start_calibration();
+
+    /**
+     * @brief Check if every Imu has finished calibrating
+     * 
+     * An Imu that reports an error, or is still calibrating after calibration_timeout,
+     * is excluded so a single dead sensor can't hold up every motion
+     * 
+     * @return if the Imu is ready to use
+     */
+    bool is_calibrated();
+
+    /**
+     * @brief Block until every Imu has finished calibrating
+     * 
+     * Returns immediately once calibration is done, so motion commands can call it every time
+     * 
+     * @param timeout the longest to wait for
+     * @return if the Imu finished calibrating before the timeout
+     */
+    bool wait_until_calibrated(au::Quantity<au::Seconds, double> timeout = au::seconds(3.0));
+
+    /**
+     * @brief Measure the gyro drift of each Imu while the robot is stationary
+     * 
+     * Waits for the gyros to read still for drift_settle_time, then measures for the
+     * given duration. Motion during the measurement, or a rate above max_drift_rate,
+     * throws it away and starts over. The measured drift is subtracted from every
+     * reading afterwards, until then the previous rates are kept.
+     * 
+     * @param duration how long to measure for, longer is more accurate
+     * @param timeout the longest to keep trying for
+     * @return if a measurement was accepted before the timeout
+     * 
+     * @b Example
+     * @code {.cpp}
+     * void disabled() {
+     *     imu.measure_drift(seconds(2));
+     * }
+     * @endcode
+    */
+    bool measure_drift(
+        au::Quantity<au::Seconds, double> duration = au::seconds(2.0), 
+        au::Quantity<au::Seconds, double> timeout = au::seconds(10.0)
+    );
     
     /**
      * @brief Get Imu rotation
      * 
+     * With multiple Imus, failed Imus and Imus that disagree with the others are
+     * excluded and the rest are averaged
+     * 
      * @b Example
      * @code {.cpp}
      * void opcontrol(){
@@ -74,7 +164,29 @@ public:
     
     Imu(ImuConfig config);
 
-    pros::Imu raw;
+    /** The most imus that can be fused, extra ports are ignored */
+    static constexpr size_t max_imus = 4;
+
+    /** How long calibration can take (ms) before the imus that haven't finished are excluded */
+    static constexpr uint32_t calibration_timeout = 3000;
+
+    /** A gyro rate above this (deg/s) means the robot is being moved, not drifting */
+    static constexpr double motion_rate = 2.0;
+
+    /** How long the gyros have to read still (ms) before drift is measured, lets a coasting drive stop */
+    static constexpr uint32_t drift_settle_time = 500;
+
+    /** The largest drift rate (deg/s) that is believed, anything faster is slow motion */
+    static constexpr double max_drift_rate = 0.05;
+
+    std::vector<pros::Imu> raw;
+
+protected:
+    // imus that failed to start calibrating, reported an error or never finished, they are never read
+    std::array<bool, max_imus> excluded{};
+
+    // if any imu that is still in use reads a gyro rate above motion_rate
+    bool is_moving();
 };
 
 }
\ No newline at end of file
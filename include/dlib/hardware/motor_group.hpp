@@ -1,6 +1,9 @@
 #pragma once
 #include "pros/motor_group.hpp"
+#include "pros/rtos.hpp"
 #include "au/au.hpp"
+#include <array>
+#include <cstdint>
 #include <initializer_list>
 
 // motor_group.hpp
@@ -14,6 +17,70 @@ struct MotorGroupConfig {
     MotorGroupConfig(std::vector<int8_t>& ports);
 };
 
+/**
+ * @brief Why a motor was excluded from the MotorGroup averages, combined as bit flags
+ * 
+ */
+enum class MotorFault : uint8_t {
+    None = 0,
+    /** The motor returned an error code, usually because it is unplugged */
+    Disconnected = 1 << 0,
+    /** The motor disagrees with the median of the group, usually from skipping gear */
+    Disagrees = 1 << 1,
+    /** The motor is above the temperature limit */
+    OverTemperature = 1 << 2,
+    /** The motor reports that it is over its current limit */
+    OverCurrent = 1 << 3
+};
+
+/**
+ * @brief The limits used to decide if a motor is healthy
+ * 
+ */
+struct MotorHealthConfig {
+    /** How far a motor's position can be from the group median */
+    au::Quantity<au::Revolutions, double> position_tolerance = au::revolutions(0.5);
+    /** How far a motor's velocity can be from the group median */
+    au::Quantity<au::Rpm, double> velocity_tolerance = au::rpm(100.0);
+    /** The temperature at which a motor is considered overheated, V5 motors start derating at 55C */
+    au::Quantity<au::Celsius, double> temperature_limit = au::celsius_qty(55.0);
+};
+
+/**
+ * @brief The state of a single motor in a MotorGroup
+ * 
+ */
+struct MotorSample {
+    au::Quantity<au::Revolutions, double> position = au::ZERO;
+    au::Quantity<au::Rpm, double> velocity = au::ZERO;
+    au::Quantity<au::Milli<au::Amperes>, double> current = au::ZERO;
+    au::Quantity<au::Celsius, double> temperature = au::ZERO;
+    au::Quantity<au::Volts, double> voltage = au::ZERO;
+    /** The MotorFault flags for this motor, or'd together */
+    uint8_t faults = 0;
+};
+
+/**
+ * @brief A snapshot of every motor in a MotorGroup, with the group averages
+ * 
+ */
+struct MotorGroupSample {
+    /** The most motors a sample can hold, the V5 brain has 21 ports */
+    static constexpr uint8_t capacity = 8;
+
+    std::array<MotorSample, capacity> motors{};
+    /** The number of motors filled in */
+    uint8_t count = 0;
+
+    au::Quantity<au::Revolutions, double> average_position = au::ZERO;
+    au::Quantity<au::Rpm, double> average_velocity = au::ZERO;
+    au::Quantity<au::Milli<au::Amperes>, double> average_current = au::ZERO;
+    au::Quantity<au::Celsius, double> max_temperature = au::ZERO;
+
+    /** Bit i is set if motor i has any fault, disconnected & disagreeing motors are excluded from the averages */
+    uint32_t fault_mask = 0;
+};
+
 class MotorGroup {
 public:
     /**
@@ -30,9 +97,17 @@ public:
      */
     void move_voltage(const au::Quantity<au::Volts, double> voltage);
 
+    /**
+     * @brief Brake the MotorGroup with its brake mode
+     * 
+     */
+    void brake();
+
     /**
      * @brief Get the MotorGroup average position in revolutions
      * 
+     * Disconnected motors and motors that disagree with the median are excluded
+     * 
      * @return revolutions
      */
     au::Quantity<au::Revolutions, double> get_position();
@@ -40,13 +115,89 @@ public:
     /**
      * @brief Get the MotorGroup average velocity in rpm
      * 
+     * Disconnected motors and motors that disagree with the median are excluded
+     * 
      * @return rpm
      */
     au::Quantity<au::Rpm, double> get_velocity();
 
+    /**
+     * @brief Read every motor in the MotorGroup in a single pass, without allocating
+     * 
+     * @param sample the caller-owned sample to fill in
+     * 
+     * @b Example
+     * @code {.cpp}
+     * // Keep the sample around between loop iterations
+     * dlib::MotorGroupSample sample;
+     * 
+     * while (true) {
+     *     motors.sample(sample);
+     *     dlib::log_info("velocity: {} rpm", sample.average_velocity.in(au::rpm));
+     *     pros::delay(20);
+     * }
+     * @endcode
+     */
+    void sample(MotorGroupSample& sample);
+
+    /**
+     * @brief Get which motors were faulted by the last get_position or sample call
+     * 
+     * get_position only detects disconnected & disagreeing motors,
+     * sample also checks temperature and current
+     * 
+     * @return bit i is set if motor i is faulted
+     */
+    uint32_t get_fault_mask() const;
+
+    /**
+     * @brief Set the limits used to decide if a motor is healthy
+     * 
+     * @param config the new limits
+     */
+    void set_health_config(MotorHealthConfig config);
+
+    /**
+     * @brief Cap the voltage move and move_voltage can send, used for power management
+     * 
+     * Commands are scaled by limit / 12V rather than clamped, so two groups with the
+     * same limit (e.g. both sides of a drive) keep the ratio between their commands
+     * 
+     * @param limit the largest voltage the motors will receive, 12V is no limit
+     */
+    void set_voltage_limit(au::Quantity<au::Volts, double> limit);
+
+    /**
+     * @brief Get the current voltage cap
+     * 
+     * @return the largest voltage the motors will receive
+     */
+    au::Quantity<au::Volts, double> get_voltage_limit() const;
+
+    /**
+     * @brief Get the last voltage sent by move or move_voltage, after the voltage limit
+     * 
+     * @return the commanded voltage
+     */
+    au::Quantity<au::Volts, double> get_commanded_voltage() const;
+
     MotorGroup(MotorGroupConfig config);
     
     pros::MotorGroup raw;
+
+protected:
+    MotorHealthConfig health_config{};
+    uint32_t fault_mask = 0;
+
+    au::Quantity<au::Volts, double> voltage_limit = au::volts(12.0);
+    au::Quantity<au::Volts, double> commanded_voltage = au::ZERO;
+
+    // the odometry, control & diagnostics tasks all read the group, guards the fields below
+    pros::Mutex mutex{};
+
+    // returned when every motor is faulted, so a dead side holds its last reading instead of jumping
+    au::Quantity<au::Revolutions, double> last_position = au::ZERO;
+    au::Quantity<au::Rpm, double> last_velocity = au::ZERO;
 };
 
 }
\ No newline at end of file
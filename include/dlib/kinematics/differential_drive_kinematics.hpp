@@ -0,0 +1,108 @@
+#pragma once
+#include "au/au.hpp"
+
+namespace dlib {
+
+// differential_drive_kinematics.hpp
+
+/**
+ * @brief The linear velocity of each side of a differential drive
+ * 
+ */
+struct WheelSpeeds {
+    /** The linear velocity of the left wheels */
+    au::Quantity<au::MetersPerSecond, double> left;
+    /** The linear velocity of the right wheels */
+    au::Quantity<au::MetersPerSecond, double> right;
+};
+
+/**
+ * @brief The velocity of a differential drive as a whole
+ * 
+ */
+struct ChassisSpeeds {
+    /** The forward velocity of the center of the chassis */
+    au::Quantity<au::MetersPerSecond, double> linear;
+    /** The rate of rotation of the chassis, positive when the right side is faster */
+    au::Quantity<au::RadiansPerSecond, double> angular;
+};
+
+class DifferentialDriveKinematics {
+public:
+    /**
+     * @brief Construct the kinematics for a differential drive
+     * 
+     * @param wheel_diameter the diameter of the drive wheels
+     * @param gear_ratio wheel revolutions per motor revolution (total rpm / motor rpm)
+     * @param track_width the distance between the centers of the left & right wheels
+     */
+    DifferentialDriveKinematics(
+        au::Quantity<au::Meters, double> wheel_diameter,
+        double gear_ratio,
+        au::Quantity<au::Meters, double> track_width
+    );
+
+    /**
+     * @brief Convert from motor revolutions to linear wheel displacement
+     * 
+     * @param revolutions the number of motor revolutions
+     * @return linear displacement
+     */
+    au::Quantity<au::Meters, double> revolutions_to_displacement(const au::Quantity<au::Revolutions, double> revolutions) const;
+
+    /**
+     * @brief Convert from motor rpm to linear wheel velocity
+     * 
+     * @param rpm the motor rpm
+     * @return linear velocity
+     */
+    au::Quantity<au::MetersPerSecond, double> rpm_to_velocity(const au::Quantity<au::Rpm, double> rpm) const;
+
+    /**
+     * @brief Convert from linear wheel velocity to motor rpm
+     * 
+     * @param velocity the linear wheel velocity
+     * @return motor rpm
+     */
+    au::Quantity<au::Rpm, double> velocity_to_rpm(const au::Quantity<au::MetersPerSecond, double> velocity) const;
+
+    /**
+     * @brief Convert the velocity of each side into the velocity of the chassis
+     * 
+     * @param wheel_speeds the linear velocity of each side
+     * @return the linear & angular velocity of the chassis
+     * 
+     * @b Example
+     * @code {.cpp}
+     * dlib::DifferentialDriveKinematics kinematics(inches(3.25), 400.0 / 600.0, inches(11.5));
+     * 
+     * dlib::ChassisSpeeds speeds = kinematics.to_chassis_speeds({
+     *     chassis.left_motors_velocity(),
+     *     chassis.right_motors_velocity()
+     * });
+     * @endcode
+     */
+    ChassisSpeeds to_chassis_speeds(const WheelSpeeds wheel_speeds) const;
+
+    /**
+     * @brief Convert a chassis velocity into the velocity each side needs
+     * 
+     * @param chassis_speeds the linear & angular velocity of the chassis
+     * @return the linear velocity of each side
+     */
+    WheelSpeeds to_wheel_speeds(const ChassisSpeeds chassis_speeds) const;
+
+    /**
+     * @brief Get the curvature of the path the chassis is driving
+     * 
+     * @param chassis_speeds the linear & angular velocity of the chassis
+     * @return the curvature (1 / turning radius), zero when not moving forward
+     */
+    au::Quantity<decltype(au::Radians{} / au::Meters{}), double> curvature(const ChassisSpeeds chassis_speeds) const;
+
+    const au::Quantity<au::Meters, double> wheel_diameter;
+    const double gear_ratio;
+    const au::Quantity<au::Meters, double> track_width;
+};
+
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace dlib {
+
+// cobs.hpp
+
+// This header is shared with the host tools, keep it free of PROS and au.
+
+/**
+ * @brief The largest encoded size of a message, COBS adds one byte per 254 plus one
+ * 
+ * @param length the length of the message
+ * @return the largest possible encoded length, not counting the 0 delimiter
+ */
+constexpr size_t cobs_max_encoded_length(size_t length) {
+    return length + length / 254 + 1;
+}
+
+/**
+ * @brief Encode a message with Consistent Overhead Byte Stuffing, so it contains no 0 bytes
+ * 
+ * Frames are then separated by a single 0 byte, which lets a reader that joins
+ * mid-stream find the start of the next frame.
+ * 
+ * @param input the message
+ * @param length the length of the message
+ * @param output where to write the encoded message, at least cobs_max_encoded_length(length) bytes
+ * @return the length of the encoded message, not counting the 0 delimiter
+ * 
+ * @b Example
+ * @code {.cpp}
+ * 
+ * uint8_t frame[dlib::cobs_max_encoded_length(sizeof(message)) + 1];
+ * size_t length = dlib::cobs_encode(message, sizeof(message), frame);
+ * frame[length++] = 0;
+ * @endcode
+ */
+size_t cobs_encode(const uint8_t* input, size_t length, uint8_t* output);
+
+/**
+ * @brief Decode a COBS encoded message
+ * 
+ * @param input the encoded message, without the 0 delimiter
+ * @param length the length of the encoded message
+ * @param output where to write the message, at least length bytes
+ * @return the length of the message, or 0 if the input is malformed
+ */
+size_t cobs_decode(const uint8_t* input, size_t length, uint8_t* output);
+
+}
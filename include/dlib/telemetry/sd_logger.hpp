@@ -0,0 +1,87 @@
+#pragma once
+#include <cstdio>
+#include <memory>
+#include "dlib/telemetry/telemetry_record.hpp"
+#include "dlib/utilities/ring_buffer.hpp"
+#include "api.h"
+
+namespace dlib {
+
+// sd_logger.hpp
+
+/**
+ * @brief Logs TelemetryRecords to the microSD card from a background task
+ * 
+ * log() only copies the record into a preallocated ring buffer, so it costs about a
+ * microsecond. A low priority task drains the buffer and writes it to the card in
+ * large blocks, which is much faster per byte than small writes.
+ */
+class SdLogger {
+public:
+    /** The number of records the buffer holds, about 2.5s at 100Hz */
+    static constexpr size_t capacity = 256;
+    /** The number of records written to the card at once */
+    static constexpr size_t block_size = 64;
+
+    /**
+     * @brief Open a log file and start the flush task
+     * 
+     * @param path the file to write, on the card paths start with /usd/
+     * @return false if there is no card or the file couldn't be opened
+     * 
+     * @b Example
+     * @code {.cpp}
+     * 
+     * dlib::SdLogger logger;
+     * logger.start("/usd/run.dlog");
+     * 
+     * // in the control loop
+     * logger.log(record);
+     * @endcode
+     */
+    bool start(const char* path);
+
+    /**
+     * @brief Queue a record to be written, safe to call from one control task
+     * 
+     * @param record the record to write
+     * @return false if the logger isn't running or the buffer was full
+     */
+    bool log(const TelemetryRecord& record);
+
+    /**
+     * @brief Write everything queued and close the file
+     * 
+     */
+    void stop();
+
+    /**
+     * @brief Check if the logger has a file open
+     * 
+     * @return if the logger is running
+     */
+    bool is_running() const;
+
+    /**
+     * @brief Get the number of records dropped because the flush task fell behind
+     * 
+     * @return the number of dropped records
+     */
+    uint32_t get_dropped() const;
+
+    ~SdLogger();
+
+protected:
+    // write one block, returns the number of records written
+    size_t flush();
+
+    RingBuffer<TelemetryRecord, capacity> buffer;
+    TelemetryRecord block[block_size];
+
+    FILE* file = nullptr;
+    std::unique_ptr<pros::Task> task = nullptr;
+    std::atomic<bool> running = false;
+    std::atomic<bool> task_done = true;
+};
+
+}
@@ -0,0 +1,188 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include "dlib/utilities/ring_buffer.hpp"
+#include "pros/rtos.hpp"
+
+// telemetry_channel.hpp
+
+/*
+ * Statically declared debug channels that compile to nothing when DLIB_TELEMETRY is 0.
+ *
+ * Declare a channel once at namespace scope, then record into it anywhere:
+ *
+ *     DLIB_TELEMETRY_CHANNEL(move_pid_voltage, double);
+ *
+ *     DLIB_TELEMETRY_RECORD(move_pid_voltage, voltage.in(volts));
+ *
+ * Recording copies the raw value and a timestamp into the channel's preallocated
+ * buffer, formatting happens later on whichever task drains the channels. When
+ * disabled, the value expression isn't evaluated at all, so it must not have side
+ * effects. Each channel must only be recorded from one task at a time.
+ */
+
+#ifndef DLIB_TELEMETRY
+#define DLIB_TELEMETRY 1
+#endif
+
+namespace dlib {
+
+/** The most channels that can be declared */
+constexpr size_t telemetry_channel_capacity = 64;
+
+/**
+ * @brief The type-erased side of a channel, used by whatever drains the channels
+ * 
+ */
+class TelemetryChannelBase {
+public:
+    /** A drained value, converted to a double off the hot path */
+    using Visitor = void (*)(const char* name, uint32_t timestamp, double value, void* context);
+
+    TelemetryChannelBase(const char* name);
+
+    /**
+     * @brief Remove recorded values, passing each to the visitor
+     * 
+     * @param visitor called once per value, oldest first
+     * @param context passed through to the visitor
+     * @param limit the most values to drain, the rest stay for the next drain
+     * @return the number of values drained
+     */
+    virtual size_t drain(Visitor visitor, void* context, size_t limit = SIZE_MAX) = 0;
+
+    /**
+     * @brief Get the number of values dropped because the channel wasn't drained in time
+     * 
+     * @return the number of dropped values
+     */
+    virtual uint32_t get_dropped() const = 0;
+
+    const char* const name;
+};
+
+/**
+ * @brief Every declared channel, filled in during static initialization
+ * 
+ */
+class TelemetryRegistry {
+public:
+    /**
+     * @brief Get the number of declared channels
+     * 
+     * @return the number of channels
+     */
+    static size_t size();
+
+    /**
+     * @brief Get a declared channel
+     * 
+     * @param index the index of the channel, less than size()
+     * @return the channel
+     */
+    static TelemetryChannelBase& get(size_t index);
+
+    /**
+     * @brief Drain every channel
+     * 
+     * Each call starts from the channel after the one the last limited call stopped
+     * on, so a busy channel can't starve the others.
+     * 
+     * @param visitor called once per value
+     * @param context passed through to the visitor
+     * @param limit the most values to drain across every channel
+     * @return the number of values drained
+     * 
+     * @b Example
+     * @code {.cpp}
+     * 
+     * // on a low priority task, in batches the log queue can hold
+     * dlib::TelemetryRegistry::drain_all([](const char* name, uint32_t timestamp, double value, void*) {
+     *     dlib::log_debug("{} {} {}", timestamp, name, value);
+     * }, nullptr, 32);
+     * @endcode
+     */
+    static size_t drain_all(TelemetryChannelBase::Visitor visitor, void* context, size_t limit = SIZE_MAX);
+
+protected:
+    friend class TelemetryChannelBase;
+
+    // returns false once the registry is full, the channel then records but is never drained
+    static bool add(TelemetryChannelBase* channel);
+};
+
+/**
+ * @brief A channel of raw values, declare with DLIB_TELEMETRY_CHANNEL
+ * 
+ * @tparam T an arithmetic type
+ * @tparam Depth how many values the channel holds between drains, must be a power of two
+ */
+template<typename T, size_t Depth = 64>
+class TelemetryChannel : public TelemetryChannelBase {
+    static_assert(std::is_arithmetic_v<T>, "telemetry channels hold raw numbers");
+
+public:
+    TelemetryChannel(const char* name) : TelemetryChannelBase(name) {
+
+    }
+
+    /**
+     * @brief Record a value, prefer DLIB_TELEMETRY_RECORD so it compiles out
+     * 
+     * @param value the value to record
+     */
+    void record(T value) {
+        this->buffer.push({pros::millis(), value});
+    }
+
+    size_t drain(Visitor visitor, void* context, size_t limit = SIZE_MAX) override {
+        Sample samples[16];
+        size_t total = 0;
+        size_t count;
+
+        while (total < limit && (count = this->buffer.pop(samples, std::min<size_t>(16, limit - total))) > 0) {
+            for (size_t i = 0; i < count; i++) {
+                visitor(this->name, samples[i].timestamp, static_cast<double>(samples[i].value), context);
+            }
+            total += count;
+        }
+
+        return total;
+    }
+
+    uint32_t get_dropped() const override {
+        return this->buffer.get_dropped();
+    }
+
+protected:
+    struct Sample {
+        uint32_t timestamp;
+        T value;
+    };
+
+    RingBuffer<Sample, Depth> buffer;
+};
+
+}
+
+#if DLIB_TELEMETRY
+
+/** Declare a telemetry channel at namespace scope */
+#define DLIB_TELEMETRY_CHANNEL(channel, type) \
+    inline ::dlib::TelemetryChannel<type> dlib_telemetry_##channel { #channel }
+
+/** Record a value into a channel declared in the same or an enclosing namespace */
+#define DLIB_TELEMETRY_RECORD(channel, value) \
+    dlib_telemetry_##channel.record(value)
+
+#else
+
+#define DLIB_TELEMETRY_CHANNEL(channel, type) \
+    static_assert(true, "")
+
+#define DLIB_TELEMETRY_RECORD(channel, value) \
+    ((void)0)
+
+#endif
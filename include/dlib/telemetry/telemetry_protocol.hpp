@@ -0,0 +1,88 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace dlib {
+
+// telemetry_protocol.hpp
+
+// This header is shared with the host tools, keep it free of PROS and au.
+
+/*
+ * Every frame is [type][payload][crc8], COBS encoded and followed by a 0 byte.
+ * Multi-byte fixed width fields are little endian.
+ *
+ * Channel:     [id u8][resolution f32][name\0][unit\0]
+ * KeySample:   [timestamp u32][count u8][zigzag varint value]...
+ * DeltaSample: [varint timestamp delta][count u8][zigzag varint value delta]...
+ *
+ * Values are sent as integer multiples of their channel's resolution. A delta
+ * sample is relative to the previous sample, so a reader must see a key sample
+ * first and wait for the next one after any bad frame.
+ */
+
+/**
+ * @brief The first byte of every frame
+ * 
+ */
+enum class TelemetryFrame : uint8_t {
+    /** Describes a channel, sent when streaming starts and repeated for late readers */
+    Channel = 1,
+    /** Every channel's absolute value */
+    KeySample = 2,
+    /** Every channel's change since the last sample */
+    DeltaSample = 3
+};
+
+/** The most channels a stream can have */
+constexpr size_t telemetry_max_channels = 32;
+/** The largest frame before COBS encoding, a key sample of every channel fits with room to spare */
+constexpr size_t telemetry_max_frame = 256;
+/** The longest channel name or unit, including the terminator */
+constexpr size_t telemetry_max_name = 24;
+
+/**
+ * @brief Write an unsigned LEB128 varint, 7 bits per byte
+ * 
+ * @param value the value to write
+ * @param output where to write it, at least 5 bytes
+ * @return the number of bytes written
+ */
+size_t write_varint(uint32_t value, uint8_t* output);
+
+/**
+ * @brief Read an unsigned LEB128 varint
+ * 
+ * @param input the bytes to read from
+ * @param length the number of bytes available
+ * @param value the value read
+ * @return the number of bytes read, or 0 if the varint is truncated or too long
+ */
+size_t read_varint(const uint8_t* input, size_t length, uint32_t& value);
+
+/**
+ * @brief Map a signed value to an unsigned one so small negative numbers stay small
+ * 
+ * @param value the signed value
+ * @return 0, -1, 1, -2, 2... become 0, 1, 2, 3, 4...
+ */
+uint32_t zigzag_encode(int32_t value);
+
+/**
+ * @brief Undo zigzag_encode
+ * 
+ * @param value the encoded value
+ * @return the signed value
+ */
+int32_t zigzag_decode(uint32_t value);
+
+/**
+ * @brief CRC-8 (polynomial 0x07) of a frame, catches frames corrupted on the wire or mixed with terminal text
+ * 
+ * @param data the frame, without its crc
+ * @param length the length of the frame
+ * @return the crc
+ */
+uint8_t telemetry_crc8(const uint8_t* data, size_t length);
+
+}
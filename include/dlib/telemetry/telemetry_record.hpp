@@ -0,0 +1,136 @@
+#pragma once
+#include <cstdint>
+
+namespace dlib {
+
+// telemetry_record.hpp
+
+// This header is shared with the host tools, keep it free of PROS and au.
+
+/**
+ * @brief What kind of motion a record was logged from, decides the units of the setpoint and error
+ * 
+ */
+enum class TelemetryMotion : uint8_t {
+    /** Not in a motion, setpoint & error are 0 */
+    None,
+    /** A linear motion, setpoint & error are in meters */
+    Linear,
+    /** A turn, setpoint & error are in degrees */
+    Angular
+};
+
+/**
+ * @brief Which controller a record was logged from, so the host tools replay it with the right gains
+ * 
+ */
+enum class TelemetryController : uint8_t {
+    /** Not in a motion */
+    None,
+    /** Robot::move_pid, linear_pid */
+    LinearPid,
+    /** Robot::move_feedforward, linear_feedforward plus linear_feedforward_pid on a profile */
+    LinearFeedforward,
+    /** Robot::move_cascade, the velocity controllers on a profile */
+    LinearCascade,
+    /** Robot::turn_absolute & turn_relative, angular_pid */
+    AngularPid,
+    /** Robot::turn_precise, precise_angular_pid */
+    PreciseAngularPid
+};
+
+/**
+ * @brief Get the kind of motion a controller runs
+ * 
+ * @param controller the controller
+ * @return the kind of motion
+ */
+constexpr TelemetryMotion telemetry_motion(TelemetryController controller) {
+    switch (controller) {
+        case TelemetryController::LinearPid:
+        case TelemetryController::LinearFeedforward:
+        case TelemetryController::LinearCascade:
+            return TelemetryMotion::Linear;
+        case TelemetryController::AngularPid:
+        case TelemetryController::PreciseAngularPid:
+            return TelemetryMotion::Angular;
+        default:
+            return TelemetryMotion::None;
+    }
+}
+
+/**
+ * @brief Check if a controller follows a motion profile, its setpoint & error move with the profile
+ * 
+ * @param controller the controller
+ * @return if the controller is profiled
+ */
+constexpr bool telemetry_profiled(TelemetryController controller) {
+    return controller == TelemetryController::LinearFeedforward || controller == TelemetryController::LinearCascade;
+}
+
+/**
+ * @brief One control loop tick, written as raw bytes to the log
+ * 
+ */
+struct TelemetryRecord {
+    /** Milliseconds since the program started */
+    uint32_t timestamp;
+    /** The index of the motion in the routine's MotionSummary */
+    uint16_t motion;
+    /** A TelemetryMotion */
+    uint8_t kind;
+    /** A SettleState */
+    uint8_t state;
+
+    /** Odometry pose, meters & radians */
+    float x;
+    float y;
+    float theta;
+
+    /** Raw sensor readings, replaying these reproduces odometry: meters & degrees */
+    float left_displacement;
+    float right_displacement;
+    float rotation;
+
+    /** Measured drive side velocities, meters per second */
+    float left_velocity;
+    float right_velocity;
+
+    /** The motion's target position & velocity, per second */
+    float setpoint_position;
+    float setpoint_velocity;
+
+    /** The voltage sent to each drive side */
+    float left_voltage;
+    float right_voltage;
+
+    /** The error passed to the controller */
+    float error;
+
+    /** A TelemetryController */
+    uint8_t controller;
+    /** Keeps the record a multiple of 4 bytes, always 0 */
+    uint8_t reserved[3];
+};
+
+static_assert(sizeof(TelemetryRecord) == 64, "TelemetryRecord must have no padding, the log format depends on it");
+
+/**
+ * @brief Written once at the start of every log file
+ * 
+ */
+struct TelemetryLogHeader {
+    /** Always telemetry_log_magic */
+    uint32_t magic;
+    /** Bumped whenever TelemetryRecord changes */
+    uint16_t version;
+    /** sizeof(TelemetryRecord), so readers can reject logs from a different layout */
+    uint16_t record_size;
+};
+
+/** "DLOG" in little endian */
+constexpr uint32_t telemetry_log_magic = 0x474F4C44;
+constexpr uint16_t telemetry_log_version = 2;
+
+}
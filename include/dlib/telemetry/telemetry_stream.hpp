@@ -0,0 +1,112 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include "dlib/telemetry/cobs.hpp"
+#include "dlib/telemetry/telemetry_protocol.hpp"
+#include "api.h"
+
+namespace dlib {
+
+// telemetry_stream.hpp
+
+struct TelemetryStreamConfig {
+    /** How often a sample of every channel is sent, in milliseconds */
+    uint32_t period = 20;
+    /** Every nth sample is a key sample, so a reader can recover from a dropped frame */
+    uint32_t key_interval = 50;
+    /** How often the channel descriptions are repeated, so a reader can join late, in milliseconds */
+    uint32_t announce_interval = 2000;
+};
+
+/**
+ * @brief Streams telemetry channels over the USB serial port as COBS framed binary
+ * 
+ * Channels are described once by name and unit, then sent as numeric ids with
+ * delta encoded values, so a sample of every channel is a few bytes. Starting the
+ * stream disables the PROS terminal's own framing, read it with the host decoder
+ * instead of the PROS terminal.
+ */
+class TelemetryStream {
+public:
+    TelemetryStream(TelemetryStreamConfig config = {});
+
+    /**
+     * @brief Add a channel, call before start
+     * 
+     * @param name the name of the channel
+     * @param unit the unit of the channel's values
+     * @param resolution the smallest change the channel can represent, values are rounded to it
+     * @return the id of the channel, or -1 if there are too many channels or the stream has started
+     * 
+     * @b Example
+     * @code {.cpp}
+     * 
+     * dlib::TelemetryStream stream;
+     * 
+     * int8_t x = stream.add_channel("x", "m", 0.001);
+     * int8_t left_voltage = stream.add_channel("left_voltage", "V", 0.01);
+     * stream.start();
+     * 
+     * // in the control loop
+     * stream.set(x, odom.get_position().x.in(meters));
+     * @endcode
+     */
+    int8_t add_channel(const char* name, const char* unit, float resolution);
+
+    /**
+     * @brief Set the latest value of a channel, it is sent with the next sample
+     * 
+     * @param id the channel id from add_channel
+     * @param value the value
+     */
+    void set(int8_t id, double value);
+
+    /**
+     * @brief Send one sample, and the channel descriptions if they are due
+     * 
+     */
+    void update();
+
+    /**
+     * @brief Disable PROS serial framing and start sending samples on a task
+     * 
+     */
+    void start();
+
+    /**
+     * @brief Check if the stream has started
+     * 
+     * @return if the stream is running
+     */
+    bool is_running() const;
+
+protected:
+    void send_channels();
+    void send_sample();
+    void send_frame(uint8_t* frame, size_t length);
+
+    const TelemetryStreamConfig config;
+
+    struct Channel {
+        char name[telemetry_max_name];
+        char unit[telemetry_max_name];
+        float resolution;
+    };
+
+    Channel channels[telemetry_max_channels];
+    size_t channel_count = 0;
+
+    // written by set from any task, read by the stream task
+    std::atomic<int32_t> values[telemetry_max_channels];
+    // the last values sent, deltas are relative to these
+    int32_t sent[telemetry_max_channels];
+
+    uint32_t last_timestamp = 0;
+    uint32_t last_announce = 0;
+    uint32_t samples = 0;
+
+    std::unique_ptr<pros::Task> task = nullptr;
+};
+
+}
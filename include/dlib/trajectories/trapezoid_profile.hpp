@@ -1,13 +1,20 @@
 #pragma once
-#include <iostream>
 #include <cmath>
 #include "au/au.hpp"
+#include "dlib/telemetry/telemetry_channel.hpp"
 #include "dlib/trajectories/profile_setpoint.hpp"
 
 namespace dlib {
 
 // trapezoid_profile.hpp
 
+// the shape of the last profile constructed, in the profile's units
+DLIB_TELEMETRY_CHANNEL(profile_accel_distance, double);
+DLIB_TELEMETRY_CHANNEL(profile_coast_distance, double);
+DLIB_TELEMETRY_CHANNEL(profile_decel_distance, double);
+DLIB_TELEMETRY_CHANNEL(profile_max_velocity, double);
+DLIB_TELEMETRY_CHANNEL(profile_total_time, double);
+
 enum class TrapezoidProfileStage {
     Accelerating,
     Coasting,
@@ -75,9 +82,9 @@ public:
             coast_distance = au::ZERO;
         } 
 
-        std::cout << accel_distance << std::endl;
-        std::cout << coast_distance << std::endl;
-        std::cout << decel_distance << std::endl;
+        DLIB_TELEMETRY_RECORD(profile_accel_distance, accel_distance.in(Units{}));
+        DLIB_TELEMETRY_RECORD(profile_coast_distance, coast_distance.in(Units{}));
+        DLIB_TELEMETRY_RECORD(profile_decel_distance, decel_distance.in(Units{}));
 
         // compute the amount of time we want to coast for
         auto coast_time = coast_distance / m_max_velocity;
@@ -85,9 +92,8 @@ public:
         // total time is all segments added together
         total_time = accel_time + decel_time + coast_time;
 
-        std::cout << m_max_velocity << std::endl;
-
-        std::cout << total_time << std::endl;
+        DLIB_TELEMETRY_RECORD(profile_max_velocity, m_max_velocity.in(au::TimeDerivative<Units>{}));
+        DLIB_TELEMETRY_RECORD(profile_total_time, total_time.in(au::seconds));
 
         accel_cutoff = accel_time;
         coast_cutoff = accel_time + coast_time;
@@ -0,0 +1,32 @@
+#pragma once
+#include "au/au.hpp"
+
+namespace dlib {
+
+// desaturate.hpp
+
+/**
+ * @brief A voltage for each side of a differential drive
+ * 
+ */
+struct SideVoltages {
+    au::Quantity<au::Volts, double> left;
+    au::Quantity<au::Volts, double> right;
+};
+
+/**
+ * @brief Scale both sides down by the same factor if either is above the limit
+ * 
+ * Clipping each side on its own changes the ratio between them, so the robot turns
+ * less than commanded at full throttle. Scaling both keeps the ratio.
+ * 
+ * @param voltages the requested voltage for each side
+ * @param max_voltage the largest voltage either side can use
+ * @return the scaled voltages
+ */
+SideVoltages desaturate(
+    const SideVoltages voltages, 
+    const au::Quantity<au::Volts, double> max_voltage
+);
+
+}
@@ -0,0 +1,191 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include "dlib/utilities/ring_buffer.hpp"
+
+// log.hpp
+
+namespace dlib {
+
+enum class LogLevel : uint8_t {
+    Debug,
+    Info,
+    Warning,
+    Error
+};
+
+enum class LogMode : uint8_t {
+    /** Format and write on the calling task, into a fixed stack buffer */
+    Immediate,
+    /** Copy the arguments into a preallocated queue, format and write on the log task */
+    Deferred
+};
+
+/**
+ * @brief One argument of a log message, stored raw until it is formatted
+ * 
+ */
+struct LogArgument {
+    enum class Type : uint8_t {
+        Integer,
+        Unsigned,
+        Double,
+        String
+    };
+
+    Type type;
+    union {
+        int64_t integer;
+        uint64_t unsigned_integer;
+        double floating;
+        const char* string;
+    };
+};
+
+/** The most arguments a message can have */
+constexpr size_t log_max_arguments = 8;
+/** The longest formatted message, longer messages are cut off */
+constexpr size_t log_max_length = 160;
+
+struct LogMessage {
+    uint32_t timestamp;
+    LogLevel level;
+    uint8_t argument_count;
+    /** Must be a string literal, it is read when the message is formatted */
+    const char* format;
+    LogArgument arguments[log_max_arguments];
+};
+
+namespace detail {
+    template<typename T>
+    LogArgument make_log_argument(T value) {
+        LogArgument argument;
+
+        if constexpr (std::is_same_v<T, const char*> || std::is_same_v<T, char*>) {
+            argument.type = LogArgument::Type::String;
+            argument.string = value;
+        } else if constexpr (std::is_floating_point_v<T>) {
+            argument.type = LogArgument::Type::Double;
+            argument.floating = value;
+        } else if constexpr (std::is_enum_v<T>) {
+            argument.type = LogArgument::Type::Integer;
+            argument.integer = static_cast<int64_t>(value);
+        } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+            argument.type = LogArgument::Type::Integer;
+            argument.integer = value;
+        } else {
+            static_assert(std::is_integral_v<T>, "log arguments must be numbers, enums or C strings, convert quantities with .in()");
+            argument.type = LogArgument::Type::Unsigned;
+            argument.unsigned_integer = value;
+        }
+
+        return argument;
+    }
+}
+
+/**
+ * @brief A logging backend that never allocates and doesn't use iostream
+ * 
+ * Messages use {} placeholders, with an optional printf style spec for numbers such
+ * as {:.2f}. In deferred mode a message costs a copy of its arguments into a
+ * preallocated queue, so string arguments must outlive the message: use literals.
+ */
+class Log {
+public:
+    /**
+     * @brief Write a message
+     * 
+     * @param level the level of the message, messages below the minimum level are skipped
+     * @param format the message, a string literal with a {} for each argument
+     * @param arguments numbers, enums or C strings
+     * 
+     * @b Example
+     * @code {.cpp}
+     * 
+     * dlib::Log::start(dlib::LogMode::Deferred);
+     * 
+     * dlib::Log::write(dlib::LogLevel::Info, "kp: {} ki: {} kd: {}", gains.kp, gains.ki, gains.kd);
+     * dlib::log_info("x: {:.2f} y: {:.2f}", pose.x.in(meters), pose.y.in(meters));
+     * @endcode
+     */
+    template<typename... Args>
+    static void write(LogLevel level, const char* format, Args... arguments) {
+        static_assert(sizeof...(Args) <= log_max_arguments, "too many log arguments");
+
+        if (level < minimum_level) {
+            return;
+        }
+
+        LogMessage message {
+            timestamp(),
+            level,
+            static_cast<uint8_t>(sizeof...(Args)),
+            format,
+            { detail::make_log_argument(arguments)... }
+        };
+
+        submit(message);
+    }
+
+    /**
+     * @brief Choose how messages are written, the log task is started for deferred mode
+     * 
+     * @param mode immediate or deferred
+     */
+    static void start(LogMode mode);
+
+    /**
+     * @brief Skip messages below a level
+     * 
+     * @param level the lowest level that is written
+     */
+    static void set_level(LogLevel level);
+
+    /**
+     * @brief Format a message into a buffer
+     * 
+     * @param message the message
+     * @param output the buffer
+     * @param size the size of the buffer
+     * @return the length of the formatted message
+     */
+    static size_t format(const LogMessage& message, char* output, size_t size);
+
+    /**
+     * @brief Get the number of deferred messages dropped because the log task fell behind
+     * 
+     * @return the number of dropped messages
+     */
+    static uint32_t get_dropped();
+
+protected:
+    static void submit(const LogMessage& message);
+    static void emit(const LogMessage& message);
+    static uint32_t timestamp();
+
+    static inline LogLevel minimum_level = LogLevel::Debug;
+    static inline LogMode mode = LogMode::Immediate;
+};
+
+template<typename... Args>
+void log_debug(const char* format, Args... arguments) {
+    Log::write(LogLevel::Debug, format, arguments...);
+}
+
+template<typename... Args>
+void log_info(const char* format, Args... arguments) {
+    Log::write(LogLevel::Info, format, arguments...);
+}
+
+template<typename... Args>
+void log_warning(const char* format, Args... arguments) {
+    Log::write(LogLevel::Warning, format, arguments...);
+}
+
+template<typename... Args>
+void log_error(const char* format, Args... arguments) {
+    Log::write(LogLevel::Error, format, arguments...);
+}
+
+}
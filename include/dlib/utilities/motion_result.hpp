@@ -0,0 +1,141 @@
+#pragma once
+#include <cstdint>
+#include "au/au.hpp"
+#include "dlib/controllers/settler.hpp"
+
+namespace dlib {
+
+// motion_result.hpp
+
+/**
+ * @brief How a single motion performed
+ *
+ */
+template<typename Units>
+struct MotionResult {
+    /** The time from the start of the motion until it exited */
+    au::Quantity<au::Seconds, double> elapsed_time = au::ZERO;
+    /** The furthest the mechanism went past the target */
+    au::Quantity<Units, double> overshoot = au::ZERO;
+    /** The error when the motion exited */
+    au::Quantity<Units, double> final_error = au::ZERO;
+    /** The number of control loop iterations */
+    int32_t ticks = 0;
+    /** Why the motion exited */
+    SettleState exit_state = SettleState::Running;
+};
+
+template<typename Units>
+class MotionTracker {
+public:
+    /**
+     * @brief Record one control loop iteration
+     *
+     * @param error distance from setpoint
+     * @param period time since the last iteration
+     *
+     * @b Example
+     * @code {.cpp}
+     *
+     * dlib::MotionTracker<Meters> tracker;
+     *
+     * while (!settler.is_done()) {
+     *     auto error = dlib::linear_error(target, chassis.forward_motor_displacement());
+     *     tracker.update(error, milli(seconds)(20));
+     *     // run the controller
+     * }
+     *
+     * dlib::MotionResult<Meters> result = tracker.finish(settler.get_state());
+     * @endcode
+    */
+    void update(au::Quantity<Units, double> error, au::Quantity<au::Seconds, double> period) {
+        result.elapsed_time += period;
+        result.final_error = error;
+        result.ticks++;
+
+        // the first nonzero error tells us which side of the target we started on
+        if (start_sign == 0 && error != au::ZERO) {
+            start_sign = error > au::ZERO ? 1 : -1;
+        }
+
+        // error with the opposite sign of the starting error means we went past the target
+        bool past_target = (start_sign == 1 && error < au::ZERO) || (start_sign == -1 && error > au::ZERO);
+        if (past_target && au::abs(error) > result.overshoot) {
+            result.overshoot = au::abs(error);
+        }
+    }
+
+    /**
+     * @brief Finish the motion
+     *
+     * @param exit_state why the motion exited
+     * @return the result of the motion
+     */
+    MotionResult<Units> finish(SettleState exit_state) {
+        result.exit_state = exit_state;
+        return result;
+    }
+
+    /**
+     * @brief Reset all of the tracker state
+     *
+     */
+    void reset() {
+        result = MotionResult<Units>{};
+        start_sign = 0;
+    }
+
+protected:
+    MotionResult<Units> result{};
+    int8_t start_sign = 0;
+};
+
+/**
+ * @brief A running summary of every motion in a routine
+ *
+ */
+class MotionSummary {
+public:
+    /**
+     * @brief Add a motion to the summary
+     *
+     * @param result the result of the motion
+     */
+    template<typename Units>
+    void add(const MotionResult<Units>& result) {
+        this->record(result.elapsed_time, result.exit_state);
+    }
+
+    /**
+     * @brief Reset the summary, call at the start of a routine
+     *
+     */
+    void reset();
+
+    /**
+     * @brief Print the summary to the terminal
+     *
+     */
+    void print() const;
+
+    /** The number of motions recorded */
+    int32_t motions = 0;
+    /** The number of motions that settled */
+    int32_t settled = 0;
+    /** The number of motions that timed out */
+    int32_t timed_out = 0;
+    /** The number of motions that stalled */
+    int32_t stalled = 0;
+
+    /** The total time spent in motions */
+    au::Quantity<au::Seconds, double> total_time = au::ZERO;
+    /** The time of the slowest motion */
+    au::Quantity<au::Seconds, double> slowest_time = au::ZERO;
+    /** The index of the slowest motion, starting from 0 */
+    int32_t slowest_motion = -1;
+
+protected:
+    void record(au::Quantity<au::Seconds, double> elapsed_time, SettleState exit_state);
+};
+
+}
@@ -0,0 +1,111 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace dlib {
+
+// ring_buffer.hpp
+
+/**
+ * @brief A fixed size, lock-free single producer single consumer queue
+ * 
+ * One task pushes and one other task pops. Neither side ever blocks or allocates,
+ * so it is safe to push from a control loop. When the buffer is full new items are
+ * dropped and counted rather than overwriting data the consumer hasn't read yet.
+ * 
+ * @tparam T the item type, copied in and out
+ * @tparam Capacity the maximum number of items, must be a power of two
+ */
+template<typename T, size_t Capacity>
+class RingBuffer {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "RingBuffer capacity must be a power of two");
+
+public:
+    /**
+     * @brief Add an item, only call from the producer task
+     * 
+     * @param item the item to add
+     * @return false if the buffer was full and the item was dropped
+     * 
+     * @b Example
+     * @code {.cpp}
+     * 
+     * dlib::RingBuffer<dlib::TelemetryRecord, 256> buffer;
+     * 
+     * // control task
+     * buffer.push(record);
+     * 
+     * // logging task
+     * dlib::TelemetryRecord out[32];
+     * size_t count = buffer.pop(out, 32);
+     * @endcode
+     */
+    bool push(const T& item) {
+        auto head = this->head.load(std::memory_order_relaxed);
+        auto tail = this->tail.load(std::memory_order_acquire);
+
+        if (head - tail >= Capacity) {
+            this->dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        this->items[head & (Capacity - 1)] = item;
+        this->head.store(head + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    /**
+     * @brief Remove up to count items, only call from the consumer task
+     * 
+     * @param out where to copy the items
+     * @param count the most items to remove
+     * @return the number of items removed
+     */
+    size_t pop(T* out, size_t count) {
+        auto tail = this->tail.load(std::memory_order_relaxed);
+        auto head = this->head.load(std::memory_order_acquire);
+
+        size_t available = head - tail;
+        if (count > available) {
+            count = available;
+        }
+
+        for (size_t i = 0; i < count; i++) {
+            out[i] = this->items[(tail + i) & (Capacity - 1)];
+        }
+
+        this->tail.store(tail + count, std::memory_order_release);
+
+        return count;
+    }
+
+    /**
+     * @brief Get the number of items waiting to be popped
+     * 
+     * @return the number of items
+     */
+    size_t size() const {
+        return this->head.load(std::memory_order_acquire) - this->tail.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Get the number of items dropped because the buffer was full
+     * 
+     * @return the number of dropped items
+     */
+    uint32_t get_dropped() const {
+        return this->dropped.load(std::memory_order_relaxed);
+    }
+
+protected:
+    T items[Capacity];
+
+    // free running counters, the index is the counter modulo the capacity
+    std::atomic<size_t> head = 0;
+    std::atomic<size_t> tail = 0;
+    std::atomic<uint32_t> dropped = 0;
+};
+
+}
@@ -0,0 +1,91 @@
+#pragma once
+#include "au/au.hpp"
+
+namespace dlib {
+
+// thermal_limiter.hpp
+
+struct ThermalLimiterConfig {
+    /** The predicted temperature at which the limiter starts reducing output */
+    au::Quantity<au::Celsius, double> soft_limit = au::celsius_qty(45.0);
+    /** The predicted temperature at which output reaches the minimum scale, V5 motors halve their current at 55C */
+    au::Quantity<au::Celsius, double> hard_limit = au::celsius_qty(55.0);
+    /** The smallest fraction of output the limiter will allow */
+    double minimum_scale = 0.5;
+    /** How far ahead to predict the temperature from its current rate of change */
+    au::Quantity<au::Seconds, double> prediction_horizon = au::seconds(10.0);
+    /** How quickly the output scale can change, per second, so the driver doesn't feel a step */
+    double max_scale_rate = 0.2;
+};
+
+/**
+ * @brief Reduces output smoothly as a motor approaches firmware thermal derating
+ * 
+ * Capping the voltage a little early keeps the robot predictable, instead of the
+ * firmware halving the current limit at 55C in the last seconds of a match.
+ */
+class ThermalLimiter {
+public:
+    ThermalLimiter(ThermalLimiterConfig config = {});
+
+    /**
+     * @brief Update the limiter with the latest temperature
+     * 
+     * @param temperature the hottest motor temperature
+     * @param period time since the last update
+     * @return the fraction of output to allow, between the minimum scale and 1
+     * 
+     * @b Example
+     * @code {.cpp}
+     * dlib::ThermalLimiter limiter;
+     * dlib::MotorGroupSample sample;
+     * 
+     * while (true) {
+     *     motors.sample(sample);
+     *     double scale = limiter.update(sample.max_temperature, milli(seconds)(100));
+     *     motors.set_voltage_limit(volts(12) * scale);
+     *     pros::delay(100);
+     * }
+     * @endcode
+     */
+    double update(au::Quantity<au::Celsius, double> temperature, au::Quantity<au::Seconds, double> period);
+
+    /**
+     * @brief Get the temperature the limiter expects at the end of the prediction horizon
+     * 
+     * @return the predicted temperature
+     */
+    au::Quantity<au::Celsius, double> get_predicted_temperature() const;
+
+    /**
+     * @brief Get the fraction of output currently allowed
+     * 
+     * @return the output scale
+     */
+    double get_scale() const;
+
+    /**
+     * @brief Reset all of the limiter state
+     * 
+     */
+    void reset();
+
+protected:
+    const ThermalLimiterConfig config;
+
+    bool has_reading = false;
+    au::Quantity<au::Celsius, double> last_temperature = au::ZERO;
+
+    // the motors only report temperature in 5C steps, so the rate comes from the time between steps
+    au::Quantity<au::Seconds, double> time_since_step = au::ZERO;
+    au::Quantity<au::Seconds, double> step_interval = au::ZERO;
+    au::Quantity<au::Celsius, double> last_step = au::ZERO;
+    // zero until a step is seen, the time spent at the first reading is unknown
+    int step_direction = 0;
+
+    au::Quantity<decltype(au::Celsius{} / au::Seconds{}), double> temperature_rate = au::ZERO;
+    au::Quantity<au::Celsius, double> predicted_temperature = au::ZERO;
+    double scale = 1;
+};
+
+}
@@ -1,12 +1,38 @@
 #pragma once
 #include "dlib/controllers/error_derivative_settler.hpp"
+#include "dlib/controllers/gain_search.hpp"
+#include "dlib/controllers/relay_autotuner.hpp"
+#include "dlib/controllers/settler.hpp"
+#include "dlib/utilities/motion_result.hpp"
 #include "dlib/dlib.hpp"
+#include "dlib/telemetry/sd_logger.hpp"
+#include "dlib/telemetry/telemetry_stream.hpp"
+#include "subsystems/color_sort.hpp"
 #include "subsystems/intake.hpp"
 #include "subsystems/pneumatics.hpp"
+#include "subsystems/power_manager.hpp"
 #include "au/au.hpp"
+#include <array>
+#include <atomic>
+#include <utility>
 
 using namespace au;
 
+// What a motion loop measured on one tick. The controllers and the log both use it,
+// so the log records exactly what the controller saw
+struct MotionSample {
+    dlib::Pose2d pose;
+    Quantity<Meters, double> left_displacement;
+    Quantity<Meters, double> right_displacement;
+    Quantity<Degrees, double> rotation;
+    Quantity<MetersPerSecond, double> left_velocity;
+    Quantity<MetersPerSecond, double> right_velocity;
+    Quantity<RadiansPerSecond, double> angular_velocity;
+
+    Quantity<Meters, double> forward_displacement() const;
+    Quantity<MetersPerSecond, double> forward_velocity() const;
+};
+
 class Robot {
 public:
 	// Drivebase
@@ -21,26 +47,64 @@ public:
 
 	// Linear PID Controllers
 	dlib::Pid<au::Meters> linear_pid;
-	dlib::ErrorDerivativeSettler<au::Meters> linear_pid_settler;
+	dlib::Settler<au::Meters> linear_pid_settler;
 
 	// Angular PID Controllers
 	dlib::Pid<au::Degrees> angular_pid;
     dlib::Pid<au::Degrees> precise_angular_pid;
-	dlib::ErrorDerivativeSettler<au::Degrees> angular_pid_settler;
-    dlib::ErrorDerivativeSettler<au::Degrees>  precise_angular_pid_settler;
+	dlib::Settler<au::Degrees> angular_pid_settler;
+    dlib::Settler<au::Degrees> precise_angular_pid_settler;
 
 	// Feedforward Controllers
 	dlib::Feedforward<au::Meters> linear_feedforward;
     dlib::Pid<au::Meters> linear_feedforward_pid;
 	dlib::Feedforward<au::Degrees> angular_feedforward;
     dlib::Pid<au::Degrees> angular_feedforward_pid;
-    dlib::ErrorDerivativeSettler<au::Meters> linear_feedforward_settler;
-    dlib::ErrorDerivativeSettler<au::Degrees> angular_feedforward_settler;
+    dlib::Settler<au::Meters> linear_feedforward_settler;
+    dlib::Settler<au::Degrees> angular_feedforward_settler;
+
+	// Cascaded Velocity Controllers (inner loop, one per side)
+	dlib::VelocityController<au::Meters> left_velocity_controller;
+	dlib::VelocityController<au::Meters> right_velocity_controller;
+
+	// Heading Hold Controller (straight drives)
+	dlib::Pid<au::Degrees> heading_hold_pid;
 
 	// Odometry
 	dlib::Odometry odom = dlib::Odometry();
 	std::unique_ptr<pros::Task> odometry_updater = nullptr;
 
+	// Telemetry, every motion loop logs a record per tick
+	dlib::SdLogger logger{};
+	dlib::TelemetryStream telemetry_stream{};
+
+	// Records for the brain's diagnostics charts, only filled while diagnostics_enabled is set
+	dlib::RingBuffer<dlib::TelemetryRecord, 128> diagnostic_records{};
+	std::atomic<bool> diagnostics_enabled{false};
+
+	// Intake jam detection
+	std::unique_ptr<pros::Task> intake_updater = nullptr;
+
+	// Color sorting
+	std::unique_ptr<ColorSort> color_sort = nullptr;
+
+	// Thermal & current limiting for the drive and intake
+	std::unique_ptr<PowerManager> power_manager = nullptr;
+
+	// Every motion is added to the summary, reset it at the start of a routine
+	dlib::MotionSummary motion_summary{};
+
+	// The targets of the current routine, drawn on the brain's field map. Fixed size so adding a
+	// target never allocates. path_version is a seqlock: odd while the points are being written,
+	// and a reader's copy is only whole if the version was even and unchanged around it
+	static constexpr size_t max_path_points = 32;
+	std::array<std::pair<double, double>, max_path_points> path_points{};
+	std::atomic<size_t> path_length{0};
+	std::atomic<uint32_t> path_version{0};
+
+	// Outer loop gain for move_cascade, meters per second of correction per meter of error
+	double cascade_position_gain = 4;
+
 	// ------------------------------------ //
 	//         Robot Class Methods          //
 	// ------------------------------------ //
@@ -48,26 +112,73 @@ public:
 	void initialize();
 
     // move controllers
-    void move_pid(au::Quantity<au::Meters, double> displacement);
-    void move_pid(double inches);
+    dlib::MotionResult<au::Meters> move_pid(au::Quantity<au::Meters, double> displacement);
+    dlib::MotionResult<au::Meters> move_pid(double inches);
+
+    dlib::MotionResult<au::Meters> move_feedforward(double displacement, double max_velocity);
 
-    void move_feedforward(double displacement, double max_velocity);
+    dlib::MotionResult<au::Meters> move_cascade(double displacement, double max_velocity);
     
     // turn controllers
-    void turn_absolute(au::Quantity<au::Degrees, double> heading);
-    void turn_absolute(double degrees);
+    dlib::MotionResult<au::Degrees> turn_absolute(au::Quantity<au::Degrees, double> heading);
+    dlib::MotionResult<au::Degrees> turn_absolute(double degrees);
 
-    void turn_relative(au::Quantity<au::Degrees, double> heading);
-    void turn_relative(double degrees);
+    dlib::MotionResult<au::Degrees> turn_relative(au::Quantity<au::Degrees, double> heading);
+    dlib::MotionResult<au::Degrees> turn_relative(double degrees);
 
-    void turn_precise(au::Quantity<au::Degrees, double> heading);
-    void turn_precise(double degrees);
+    dlib::MotionResult<au::Degrees> turn_precise(au::Quantity<au::Degrees, double> heading);
+    dlib::MotionResult<au::Degrees> turn_precise(double degrees);
 
     // primary movements
-    void move(double x, double y, double max_velocity = 1.6, bool reverse = false, bool precise_turn = false);
-    void turn(double x, double y, bool reverse = false);
-    void turn_with_precision(double x, double y, bool reverse = false);
+    dlib::MotionResult<au::Meters> move(double x, double y, double max_velocity = 1.6, bool reverse = false, bool precise_turn = false);
+    dlib::MotionResult<au::Degrees> turn(double x, double y, bool reverse = false);
+    dlib::MotionResult<au::Degrees> turn_with_precision(double x, double y, bool reverse = false);
+
+    // add a motion to the summary and pass it through to the caller
+    template<typename Units>
+    dlib::MotionResult<Units> record_motion(dlib::MotionResult<Units> result) {
+        motion_summary.add(result);
+        return result;
+    }
+
+    // planned path, move adds its targets, clear it at the start of a routine
+    void clear_path();
+    void add_path_point(double x, double y);
+
+    // autotuning
+    dlib::PidGains autotune_linear(
+        dlib::RelayAutotunerConfig<au::Meters> config, 
+        dlib::ZieglerNicholsRule rule = dlib::ZieglerNicholsRule::Pd
+    );
+    dlib::PidGains autotune_angular(
+        dlib::RelayAutotunerConfig<au::Degrees> config, 
+        dlib::ZieglerNicholsRule rule = dlib::ZieglerNicholsRule::Pd
+    );
+
+    dlib::PidGains refine_linear_gains(dlib::GainSearchConfig config, double displacement = 0.6, double overshoot_weight = 10);
+    dlib::PidGains refine_angular_gains(dlib::GainSearchConfig config, double degrees = 90, double overshoot_weight = 0.05);
+
+    // read everything a motion loop uses once per tick
+    MotionSample sample_motion();
+
+    // log one control loop tick, setpoint & error are in meters for linear motions and degrees for turns
+    void log_tick(dlib::TelemetryController controller, const MotionSample& sample, double setpoint_position, double setpoint_velocity, double error, dlib::SettleState state);
+
+    // open the next free /usd/run_N.dlog and start logging to it
+    bool start_logging();
+
+    // stream the same values as the log over the serial port, read with tools/telemetry_decoder
+    void start_streaming();
 
     // odometry task
     void start_odom();	
+
+    // intake jam detection task
+    void start_intake();
+
+    // color sort task
+    void start_color_sort(ColorSortConfig config);
+
+    // power management task
+    void start_power_management(PowerManagerConfig config = {});
 };
\ No newline at end of file
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "subsystems/intake.hpp"
+#include "api.h"
+#include <cstddef>
+
+// which selector page a routine is listed on
+enum class AutonCategory {
+    Red,
+    Blue,
+    Skills
+};
+
+struct Auton {
+    const char * name;
+    AutonCategory category;
+    void (*routine)();
+    // optional, runs in the background as soon as the routine is selected so its paths & profiles
+    // are ready before autonomous starts
+    void (*prepare)() = nullptr;
+};
+
+// the most routines the registry can hold
+constexpr size_t max_autons = 16;
+
+// add a routine to the selector, register every routine before initialize_brain builds the gui
+bool register_auton(Auton auton);
+
+size_t get_auton_count();
+const Auton& get_auton(size_t index);
+
+// select a routine by its registry index and start preparing it, returns false for a bad index
+bool select_auton(size_t index);
+
+// the selected routine, nullptr until one is selected
+const Auton* get_selected_auton();
+
+// called with the routine whenever the selection changes, e.g. to set the color sort's alliance
+void on_auton_selected(void (*callback)(const Auton&));
+
+// the alliance a routine plays on, skills is played as red
+Alliance get_auton_alliance(const Auton& auton);
+
+// finish preparing the selected routine if it isn't ready yet, then run it
+// returns false if nothing is selected
+bool run_selected_auton();
@@ -1,9 +1,25 @@
 #pragma once
 #include "liblvgl/lvgl.h"
 #include "robot.hpp"
+#include "subsystems/auton_selector.hpp"
+#include "subsystems/diagnostics.hpp"
+#include "subsystems/field_map.hpp"
 
 
+struct DashboardConfig {
+    // how often the dashboard is refreshed (ms), the screen doesn't need the control loop's rate
+    uint32_t period = 100;
+    // coordinates are rounded to this before being shown, matches the 2 decimal places shown (m)
+    double coordinate_resolution = 0.01;
+    // the field map page, drawn from odometry & the robot's planned path
+    FieldMapConfig field_map{};
+    // the diagnostics page, charts of the motion loops' telemetry
+    DiagnosticsConfig diagnostics{};
+};
+
 void initialize_brain();
 void print_coords(Robot& robot);
 void update_battery_percent();
-int get_selected();
\ No newline at end of file
+
+// refresh the coordinates, battery, field map & diagnostics on a low priority task, only touching widgets whose value changed
+void start_dashboard(Robot& robot, DashboardConfig config = {});
\ No newline at end of file
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "dlib/dlib.hpp"
+#include "subsystems/intake.hpp"
+#include "api.h"
+#include <array>
+#include <optional>
+
+struct HueRange {
+    // hues wrap around at 360, so min can be greater than max (e.g. red is 340 -> 20)
+    double min;
+    double max;
+
+    bool contains(double hue) const;
+};
+
+struct ColorSortConfig {
+    int8_t optical_port;
+
+    HueRange red_hue = {340, 20};
+    HueRange blue_hue = {180, 250};
+
+    // an object closer than this is in front of the sensor (0-255)
+    int32_t min_proximity = 100;
+
+    // how far an object travels from the sensor to where it gets flung off
+    au::Quantity<au::Meters, double> eject_distance = au::inches(4.0);
+    // the diameter of the roller carrying objects past the sensor, converts motor rpm to surface speed
+    au::Quantity<au::Meters, double> roller_diameter = au::inches(2.0);
+
+    // which intake motor carries & ejects objects (0: intake_motor, 1: intake_motor_2, 2: middle_motor)
+    size_t eject_motor = 0;
+    // what the eject motor is driven at while ejecting (millivolts)
+    int32_t eject_voltage = -12000;
+    // how long to eject for (ms)
+    uint32_t eject_time = 120;
+
+    // how often the sensor is read (ms), the optical sensor updates every 3ms at its fastest integration time
+    uint32_t update_period = 5;
+};
+
+class ColorSort {
+public:
+    Intake& intake;
+    ColorSortConfig config;
+    pros::Optical optical;
+
+    // the most opposite color objects that can be between the sensor and the eject point at once
+    static constexpr size_t max_pending = 4;
+
+    // how far each opposite color object on its way to the eject point still has to go, oldest first
+    // a circular queue, pending_head is the oldest object
+    std::array<au::Quantity<au::Meters, double>, max_pending> pending{};
+    size_t pending_head = 0;
+    size_t pending_count = 0;
+
+    // the object in front of the sensor has already been classified
+    bool object_present = false;
+
+    bool ejecting = false;
+    uint32_t eject_start = 0;
+
+    uint32_t last_update = 0;
+
+    // how many objects have been ejected
+    int32_t ejected = 0;
+
+    std::unique_ptr<pros::Task> task = nullptr;
+
+    ColorSort(
+        Intake& intake,
+        ColorSortConfig config
+    );
+
+    void update(void);
+
+    // runs update on a high priority task, so ejection timing doesn't depend on the driver loop
+    void start(void);
+
+    // the color of an object from its hue, if it matches either alliance
+    std::optional<Alliance> classify(double hue);
+
+    // how fast objects move past the sensor
+    au::Quantity<au::MetersPerSecond, double> surface_speed(void);
+};
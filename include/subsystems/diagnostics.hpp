@@ -0,0 +1,21 @@
+#pragma once
+#include "liblvgl/lvgl.h"
+#include "robot.hpp"
+
+// the number of points each chart shows
+constexpr size_t diagnostic_chart_points = 100;
+
+struct DiagnosticsConfig {
+    // keep one of every this many control loop ticks, at 10ms ticks 5 shows the last 5 seconds
+    uint32_t decimation = 5;
+    // how often the charts are redrawn while they are on screen (ms)
+    uint32_t redraw_period = 200;
+    // how often motor temperatures are added to their chart (ms), they change slowly
+    uint32_t temperature_period = 1000;
+};
+
+// create the error, voltage, velocity & temperature charts on the parent, call once
+void create_diagnostics(lv_obj_t * parent, DiagnosticsConfig config = {});
+
+// add the robot's latest telemetry to the charts, redrawing at most once per redraw_period
+void update_diagnostics(Robot& robot);
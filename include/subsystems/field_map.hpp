@@ -0,0 +1,28 @@
+#pragma once
+#include "liblvgl/lvgl.h"
+#include "robot.hpp"
+
+// the largest map that fits in the canvas buffer (px)
+constexpr lv_coord_t max_field_map_size = 200;
+
+struct FieldMapConfig {
+    // where the odometry origin sits on the field, measured from the bottom left corner (m)
+    // +x is to the right of the screen and +y is up
+    double origin_x = 1.8288;
+    double origin_y = 1.8288;
+    // the side length of the field (m)
+    double field_size = 3.6576;
+    // the side length of the map on the screen, up to max_field_map_size (px)
+    lv_coord_t size = 160;
+    // the robot has to move this far before a new trail segment is drawn (m)
+    double trail_spacing = 0.02;
+};
+
+// draw the field into a canvas on the parent, call once
+void create_field_map(lv_obj_t * parent, FieldMapConfig config = {});
+
+// draw the latest pose, trail, path & tracking error, only repainting what changed
+void update_field_map(Robot& robot);
+
+// erase the trail, e.g. after resetting odometry
+void clear_field_map_trail();
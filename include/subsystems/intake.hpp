@@ -8,21 +8,72 @@ enum class Alliance {
     Blue
 };
 
+enum class IntakeState {
+    // following the last command
+    Running,
+    // a motor stalled, reversing to clear it
+    Unjamming,
+    // jammed too many times in a row, stopped until the next new command
+    Faulted
+};
+
+struct IntakeJamConfig {
+    // only look for jams on motors commanded at least this hard (millivolts)
+    int32_t min_voltage = 6000;
+    // a commanded motor spinning slower than this is stalled (rpm)
+    double jam_velocity = 60;
+    // consecutive stalled updates before it counts as a jam
+    uint32_t jam_ticks = 3;
+    // how long to reverse for when a jam is detected (ms)
+    uint32_t reverse_time = 100;
+    // time after a new command or an unjam for the motors to spin up (ms)
+    uint32_t spin_up_time = 150;
+    // unjams without a clean spin up in between before giving up
+    uint32_t max_attempts = 4;
+};
+
 class Intake {
 public:
     pros::Motor intake_motor;
     pros::Motor intake_motor_2;
     pros::Motor middle_motor;
-    Alliance alliance;
-    bool do_sort;
+    Alliance alliance = Alliance::Red;
+    bool do_sort = false;
     int8_t direction = 1;
 
+    // set by the power manager, every command is capped to this (millivolts)
+    int32_t voltage_limit = 12000;
+
+    IntakeJamConfig jam_config;
+
+    // the state below is shared between the driver, color sort & intake tasks, only touch it while holding this
+    pros::Mutex mutex;
+
+    IntakeState state = IntakeState::Running;
+
+    // the last commanded voltage of each motor (intake_motor, intake_motor_2, middle_motor), 0 is brake
+    int32_t commanded[3] = {0, 0, 0};
+    uint32_t stalled_ticks[3] = {0, 0, 0};
+    uint32_t unjam_attempts = 0;
+    // when the current state started, or the motors were last given a new command
+    uint32_t state_start = 0;
+    uint32_t command_start = 0;
+
+    // set by the color sort, overrides one motor's command while an object is flung off
+    bool ejecting = false;
+    size_t eject_motor = 0;
+    int32_t eject_voltage = 0;
+
     Intake(
         int8_t motor_port,
         int8_t bottom_motor,
-        int8_t middle_motor_p
+        int8_t middle_motor_p,
+        IntakeJamConfig jam_config = {}
     );
 
+    // copies the ports & settings, the copy gets its own mutex
+    Intake(const Intake& other);
+
     void set_alliance(Alliance alliance);
 
     void move(uint8_t power);
@@ -43,4 +94,28 @@ public:
 
     void toggle_direction(void);
 
+    void set_voltage_limit(int32_t millivolts);
+
+    int32_t limit_voltage(int32_t millivolts);
+
+    // run the jam detection state machine, call periodically (every 10ms)
+    void update(void);
+
+    IntakeState get_state(void);
+
+    void start_eject(size_t motor_index, int32_t millivolts);
+
+    void stop_eject(void);
+
+protected:
+    pros::Motor& motor(size_t index);
+
+    // record the command for a motor, and send it unless an unjam is in progress
+    void command(size_t index, int32_t millivolts);
+
+    // the caller must hold the mutex
+    void send(size_t index, int32_t millivolts);
+
+    void set_state(IntakeState state);
+
 };
\ No newline at end of file
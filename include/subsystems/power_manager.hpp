@@ -0,0 +1,55 @@
+#pragma once
+
+#include "dlib/dlib.hpp"
+#include "subsystems/intake.hpp"
+#include "api.h"
+
+struct PowerManagerConfig {
+    // drive & intake thermal derating
+    dlib::ThermalLimiterConfig drive_thermal{};
+    dlib::ThermalLimiterConfig intake_thermal{};
+
+    // an intake motor drawing this much current while barely moving is jammed
+    int32_t jam_current = 2000;     // mA
+    double jam_velocity = 30;       // rpm
+    uint32_t jam_time = 200;        // ms
+
+    // current limit for a jammed intake motor, so it doesn't cook itself pushing on a stuck block
+    int32_t jammed_current_limit = 1200;    // mA
+    int32_t normal_current_limit = 2500;    // mA
+
+    uint32_t update_period = 100;   // ms
+};
+
+class PowerManager {
+public:
+    dlib::Chassis& chassis;
+    Intake& intake;
+    PowerManagerConfig config;
+
+    dlib::ThermalLimiter drive_limiter;
+    dlib::ThermalLimiter intake_limiter;
+
+    dlib::MotorGroupSample left_sample;
+    dlib::MotorGroupSample right_sample;
+
+    // time each intake motor has looked jammed, and whether its current is limited
+    uint32_t jam_timers[3] = {0, 0, 0};
+    bool jammed[3] = {false, false, false};
+
+    std::unique_ptr<pros::Task> task = nullptr;
+
+    PowerManager(
+        dlib::Chassis& chassis,
+        Intake& intake,
+        PowerManagerConfig config = {}
+    );
+
+    void update(void);
+
+    void start(void);
+
+    double get_drive_scale(void);
+
+    double get_intake_scale(void);
+};
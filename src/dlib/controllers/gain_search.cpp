@@ -0,0 +1,104 @@
+#include "dlib/controllers/gain_search.hpp"
+#include <cmath>
+#include <limits>
+
+namespace dlib {
+
+// gain_search.cpp
+
+GainSearch::GainSearch(GainSearchConfig config) : config(config) {
+    this->reset();
+}
+
+void GainSearch::reset() {
+    best_gains = config.initial_gains;
+    candidate = config.initial_gains;
+    best_cost = std::numeric_limits<double>::infinity();
+    step = config.initial_step;
+
+    coordinate = 0;
+    direction = 1;
+    failed_coordinates = 0;
+    trials = 0;
+
+    has_baseline = false;
+}
+
+PidGains GainSearch::next_candidate() {
+    candidate = best_gains;
+
+    // the first trial measures the starting gains so there is something to beat
+    if (!has_baseline) {
+        return candidate;
+    }
+
+    double* gain = &candidate.kp;
+    if (coordinate == 1) {
+        gain = &candidate.ki;
+    } else if (coordinate == 2) {
+        gain = &candidate.kd;
+    }
+
+    // gains that start at zero are stepped relative to kp so they can still move
+    double scale = *gain != 0 ? std::abs(*gain) : 0.1 * std::abs(best_gains.kp);
+    *gain = std::max(*gain + direction * step * scale, 0.0);
+
+    return candidate;
+}
+
+void GainSearch::report(double cost) {
+    trials++;
+
+    if (!has_baseline) {
+        best_cost = cost;
+        has_baseline = true;
+        return;
+    }
+
+    if (cost < best_cost) {
+        // keep pushing the same gain in the same direction while it improves
+        best_gains = candidate;
+        best_cost = cost;
+        failed_coordinates = 0;
+        return;
+    }
+
+    if (direction == 1) {
+        direction = -1;
+        return;
+    }
+
+    this->advance();
+}
+
+bool GainSearch::is_done() const {
+    return trials >= config.max_trials || step < config.minimum_step;
+}
+
+PidGains GainSearch::get_best_gains() const {
+    return best_gains;
+}
+
+double GainSearch::get_best_cost() const {
+    return best_cost;
+}
+
+void GainSearch::advance() {
+    int32_t coordinate_count = config.search_ki ? 3 : 2;
+
+    direction = 1;
+    coordinate = (coordinate + 1) % 3;
+
+    if (coordinate == 1 && !config.search_ki) {
+        coordinate = 2;
+    }
+
+    // every gain was tried in both directions without improving, refine the step
+    failed_coordinates++;
+    if (failed_coordinates >= coordinate_count) {
+        failed_coordinates = 0;
+        step /= 2;
+    }
+}
+
+}
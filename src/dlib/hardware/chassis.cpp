@@ -3,6 +3,9 @@
 #include "motor_group.hpp"
 #include "pros/abstract_motor.hpp"
 #include "pros/motors.h"
+#include "pros/rtos.hpp"
+#include <algorithm>
+#include <cmath>
 
 namespace dlib {
 
@@ -13,13 +16,17 @@ ChassisConfig::ChassisConfig(
     MotorGroupConfig right_motors_config,
     pros::MotorGearset drive_gearset,
     au::Quantity<au::Rpm, double> total_rpm,
-    au::Quantity<au::Meters, double> wheel_diameter
+    au::Quantity<au::Meters, double> wheel_diameter,
+    au::Quantity<au::Meters, double> track_width,
+    DriverControlConfig driver_control
 )  :
     left_motors(left_motors_config),
     right_motors(right_motors_config),
     drive_gearset(drive_gearset),
     total_rpm(total_rpm),
-    wheel_diameter(wheel_diameter) {
+    wheel_diameter(wheel_diameter),
+    track_width(track_width),
+    driver_control(driver_control) {
 
     switch (drive_gearset) {
         case pros::MotorGearset::red: this->base_rpm = au::rpm(100); break;
@@ -37,7 +44,9 @@ Chassis::Chassis(
     drive_gearset(config.drive_gearset),
     base_rpm(config.base_rpm),
     total_rpm(config.total_rpm), 
-    wheel_diameter(config.wheel_diameter) {
+    wheel_diameter(config.wheel_diameter),
+    kinematics(config.wheel_diameter, config.total_rpm / config.base_rpm, config.track_width),
+    driver_control(config.driver_control) {
     
 
 }
@@ -73,41 +82,105 @@ void Chassis::turn_voltage(const au::Quantity<au::Volts, double> voltage) {
     this->right_motors.move_voltage(-voltage);
 }
 
+void Chassis::tank_voltage(const au::Quantity<au::Volts, double> left_voltage, const au::Quantity<au::Volts, double> right_voltage) {
+    auto voltages = desaturate({left_voltage, right_voltage}, au::volts(12));
+
+    this->left_motors.move_voltage(voltages.left);
+    this->right_motors.move_voltage(voltages.right);
+}
+
+void Chassis::arcade_voltage(const au::Quantity<au::Volts, double> linear_voltage, const au::Quantity<au::Volts, double> turn_voltage) {
+    this->tank_voltage(linear_voltage + turn_voltage, linear_voltage - turn_voltage);
+}
+
 void Chassis::arcade(const int32_t power, const int32_t turn) {
-    
-    this->left_motors.move((power + turn*.5));
-    this->right_motors.move((power - turn*.5)*.91);
+    auto max_voltage = this->driver_control.max_voltage;
+    auto throttle = this->shape_input(power, this->driver_control.throttle_curve);
+    auto rotation = this->shape_input(turn, this->driver_control.turn_curve) * this->driver_control.turn_scale;
+
+    this->drive_slewed(
+        max_voltage * (throttle + rotation), 
+        max_voltage * (throttle - rotation)
+    );
+}
+
+void Chassis::tank(const int32_t left, const int32_t right) {
+    auto max_voltage = this->driver_control.max_voltage;
+
+    this->drive_slewed(
+        max_voltage * this->shape_input(left, this->driver_control.throttle_curve), 
+        max_voltage * this->shape_input(right, this->driver_control.throttle_curve)
+    );
+}
+
+void Chassis::curvature(const int32_t throttle, const int32_t turn, const bool quick_turn) {
+    auto max_voltage = this->driver_control.max_voltage;
+    auto forward = this->shape_input(throttle, this->driver_control.throttle_curve);
+    auto rotation = this->shape_input(turn, this->driver_control.turn_curve) * this->driver_control.turn_scale;
+
+    // with no throttle there is no curvature to follow, so turn in place like arcade
+    if (quick_turn || forward == 0) {
+        this->drive_slewed(max_voltage * (forward + rotation), max_voltage * (forward - rotation));
+        return;
+    }
+
+    auto curvature = std::abs(forward) * rotation;
+    this->drive_slewed(max_voltage * (forward + curvature), max_voltage * (forward - curvature));
+}
+
+double Chassis::shape_input(const int32_t input, const DriveCurveConfig curve) const {
+    auto magnitude = std::min(std::abs(input) / 127.0, 1.0);
+    auto deadband = curve.deadband / 127.0;
+
+    if (magnitude <= deadband) {
+        return 0;
+    }
+
+    // rescale so the output starts from zero at the edge of the deadband
+    auto scaled = (magnitude - deadband) / (1 - deadband);
+    auto shaped = (1 - curve.expo) * scaled + curve.expo * scaled * scaled * scaled;
+
+    return std::copysign(shaped, static_cast<double>(input));
+}
+
+void Chassis::drive_slewed(const au::Quantity<au::Volts, double> left_voltage, const au::Quantity<au::Volts, double> right_voltage) {
+    auto now = pros::millis();
+    auto period = au::milli(au::seconds)(static_cast<double>(now - this->last_drive_time));
+    this->last_drive_time = now;
+
+    // if driver control hasn't run recently the outputs are stale, start from rest
+    if (period > au::milli(au::seconds)(100.0)) {
+        this->left_output = au::ZERO;
+        this->right_output = au::ZERO;
+    }
+
+    // scale power & turn together so a full stick turn still turns at full throttle
+    auto target = desaturate({left_voltage, right_voltage}, this->driver_control.max_voltage);
+
+    if (this->driver_control.slew_rate > au::ZERO) {
+        au::Quantity<au::Volts, double> max_change = this->driver_control.slew_rate * period;
+
+        this->left_output += std::clamp(target.left - this->left_output, -max_change, max_change);
+        this->right_output += std::clamp(target.right - this->right_output, -max_change, max_change);
+    } else {
+        this->left_output = target.left;
+        this->right_output = target.right;
+    }
+
+    this->tank_voltage(this->left_output, this->right_output * this->driver_control.right_side_scale);
 }
 //meow meow meow meow meow meow meow meow meow meow
 void Chassis::brake() {
-    this->left_motors.raw.brake();
-    this->right_motors.raw.brake();
+    this->left_motors.brake();
+    this->right_motors.brake();
 }
 
 au::Quantity<au::Meters, double> Chassis::revolutions_to_displacement(const au::Quantity<au::Revolutions, double> revolutions) const {
-    // TODO: move the motor position -> wheel position conversions to a dedicated kinematics class
-
-    // not sure if there's a unit-safe way to do this
-    auto wheel_circumference = this->wheel_diameter.in(au::meters) * M_PI;
-    auto linear_distance = 
-        revolutions.in(au::revolutions) 
-        * wheel_circumference 
-        * (this->total_rpm / this->base_rpm);
-    
-    return au::meters(linear_distance);
+    return this->kinematics.revolutions_to_displacement(revolutions);
 }
 
 au::Quantity<au::MetersPerSecond, double> Chassis::rpm_to_velocity(const au::Quantity<au::Rpm, double> rpm) const {
-    // TODO: move the motor velocity -> wheel velocity conversions to a dedicated kinematics class
-    
-    // not sure if there's a unit-safe way to do this
-    auto wheel_circumference = this->wheel_diameter.in(au::meters) * M_PI;
-    auto linear_velocity = 
-        (rpm.in(au::rps) 
-        * wheel_circumference 
-        * (this->total_rpm / this->base_rpm));
-    
-    return au::meters_per_second(linear_velocity);
+    return this->kinematics.rpm_to_velocity(rpm);
 }
 
 au::Quantity<au::Meters, double> Chassis::left_motors_displacement() {
@@ -147,7 +220,18 @@ au::Quantity<au::MetersPerSecond, double> Chassis::right_motors_velocity() {
 }
 
 au::Quantity<au::MetersPerSecond, double> Chassis::forward_motor_velocity() {
-    return (this->left_motors_velocity() + this->left_motors_velocity()) / 2.0;
+    return (this->left_motors_velocity() + this->right_motors_velocity()) / 2.0;
+}
+
+au::Quantity<au::RadiansPerSecond, double> Chassis::angular_velocity() {
+    return this->chassis_speeds().angular;
+}
+
+ChassisSpeeds Chassis::chassis_speeds() {
+    return this->kinematics.to_chassis_speeds({
+        this->left_motors_velocity(),
+        this->right_motors_velocity()
+    });
 }
 
 }
\ No newline at end of file
@@ -1,32 +1,264 @@
 #include "dlib/hardware/imu.hpp"
 #include "au/au.hpp"
+#include "pros/error.h"
+#include <algorithm>
+#include <cmath>
+#include <mutex>
 
 namespace dlib {
 
 // imu.cpp
 
-ImuConfig::ImuConfig(int8_t port, double scalar) : port(port), scalar(scalar) {
+ImuConfig::ImuConfig(int8_t port, double scalar) : ports({port}), scalar(scalar), fusion_tolerance(au::degrees(2.0)) {
 
 }
 
-Imu::Imu(ImuConfig config) : raw(config.port), scalar(config.scalar) {
+ImuConfig::ImuConfig(
+    std::vector<int8_t> ports, 
+    double scalar, 
+    au::Quantity<au::Degrees, double> fusion_tolerance
+) : ports(ports), scalar(scalar), fusion_tolerance(fusion_tolerance) {
 
 }
 
+Imu::Imu(ImuConfig config) : scalar(config.scalar), fusion_tolerance(config.fusion_tolerance) {
+    for (auto port : config.ports) {
+        if (this->raw.size() == max_imus) {
+            break;
+        }
+
+        this->raw.emplace_back(port);
+        this->drift_rates.push_back(au::ZERO);
+        this->drift_offsets.push_back(au::ZERO);
+    }
+}
+
 void Imu::initialize() {
-    this->raw.reset(true);
+    this->start_calibration();
+    this->wait_until_calibrated();
+}
+
+void Imu::start_calibration() {
+    std::lock_guard<pros::Mutex> guard(this->mutex);
+
+    // every imu calibrates at the same time, one that can't start is left out
+    for (size_t i = 0; i < this->raw.size(); i++) {
+        this->excluded[i] = this->raw[i].reset(false) == PROS_ERR;
+    }
+
+    this->calibration_start_time = pros::millis();
+    this->calibration_started = true;
+    this->calibrated = false;
+    this->last_rotation = au::ZERO;
+}
+
+bool Imu::is_calibrated() {
+    std::lock_guard<pros::Mutex> guard(this->mutex);
+
+    if (this->calibrated || !this->calibration_started) {
+        return this->calibrated;
+    }
+
+    // the imus take a moment to report that they have started calibrating
+    if (pros::millis() - this->calibration_start_time < 50) {
+        return false;
+    }
+
+    bool timed_out = pros::millis() - this->calibration_start_time >= calibration_timeout;
+    bool calibrating = false;
+
+    for (size_t i = 0; i < this->raw.size(); i++) {
+        if (this->excluded[i]) {
+            continue;
+        }
+
+        // an unplugged or failed imu reports the error status, which also reads as calibrating
+        if (this->raw[i].get_status() == pros::ImuStatus::error) {
+            this->excluded[i] = true;
+        } else if (this->raw[i].is_calibrating()) {
+            // past the timeout an imu that is still calibrating is treated as failed
+            if (timed_out) {
+                this->excluded[i] = true;
+            } else {
+                calibrating = true;
+            }
+        }
+    }
+
+    if (calibrating) {
+        return false;
+    }
+
+    // latched even if every imu was excluded, get_rotation then holds its last value
+    this->calibrated = true;
+    this->drift_start_time = pros::millis();
+    std::fill(this->drift_offsets.begin(), this->drift_offsets.end(), au::ZERO);
+    return true;
+}
+
+bool Imu::wait_until_calibrated(au::Quantity<au::Seconds, double> timeout) {
+    auto start_time = pros::millis();
+
+    while (!this->is_calibrated()) {
+        if (au::milli(au::seconds)(static_cast<double>(pros::millis() - start_time)) >= timeout) {
+            return false;
+        }
+
+        pros::delay(10);
+    }
+
+    return true;
+}
+
+bool Imu::is_moving() {
+    for (size_t i = 0; i < this->raw.size(); i++) {
+        if (this->excluded[i]) {
+            continue;
+        }
+
+        auto rate = this->raw[i].get_gyro_rate().z;
+        if (rate != PROS_ERR_F && std::abs(rate) > motion_rate) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool Imu::measure_drift(au::Quantity<au::Seconds, double> duration, au::Quantity<au::Seconds, double> timeout) {
+    this->wait_until_calibrated();
+
+    // measured without holding the mutex, disabled() can be ended by a mode change at any point
+    std::array<double, max_imus> start_rotations{};
+    std::array<double, max_imus> end_rotations{};
+
+    auto attempt_start = pros::millis();
+    auto still_since = attempt_start;
+    uint32_t start_time = 0;
+    bool measuring = false;
+
+    while (au::milli(au::seconds)(static_cast<double>(pros::millis() - attempt_start)) < timeout) {
+        auto now = pros::millis();
+
+        // the robot is placed by hand or still coasting from auton, wait for it to settle and start over
+        if (this->is_moving()) {
+            still_since = now;
+            measuring = false;
+        } else if (!measuring && now - still_since >= drift_settle_time) {
+            for (size_t i = 0; i < this->raw.size(); i++) {
+                start_rotations[i] = this->raw[i].get_rotation();
+            }
+
+            start_time = now;
+            measuring = true;
+        } else if (measuring && au::milli(au::seconds)(static_cast<double>(now - start_time)) >= duration) {
+            auto elapsed_time = au::milli(au::seconds)(static_cast<double>(now - start_time));
+
+            std::array<au::Quantity<au::DegreesPerSecond, double>, max_imus> rates{};
+            std::array<bool, max_imus> valid{};
+            bool plausible = true;
+
+            for (size_t i = 0; i < this->raw.size(); i++) {
+                end_rotations[i] = this->raw[i].get_rotation();
+
+                // an imu that failed during the measurement keeps its old drift rate
+                valid[i] = !this->excluded[i] && start_rotations[i] != PROS_ERR_F && end_rotations[i] != PROS_ERR_F;
+                if (!valid[i]) {
+                    continue;
+                }
+
+                rates[i] = au::degrees((end_rotations[i] - start_rotations[i]) * this->scalar) / elapsed_time;
+                plausible = plausible && au::abs(rates[i]) <= au::degrees_per_second(max_drift_rate);
+            }
+
+            // too slow for the gyro rate check but too fast to be drift, the robot was being turned
+            if (!plausible) {
+                still_since = now;
+                measuring = false;
+                pros::delay(10);
+                continue;
+            }
+
+            std::lock_guard<pros::Mutex> guard(this->mutex);
+
+            // keep the compensation applied so far, so restarting from start_time doesn't make the heading jump
+            auto previous_time = au::milli(au::seconds)(static_cast<double>(start_time - this->drift_start_time));
+
+            for (size_t i = 0; i < this->raw.size(); i++) {
+                this->drift_offsets[i] += this->drift_rates[i] * previous_time;
+
+                if (valid[i]) {
+                    this->drift_rates[i] = rates[i];
+                }
+            }
+
+            // compensate from the start of the measurement, so the heading holds still while stationary
+            this->drift_start_time = start_time;
+            return true;
+        }
+
+        pros::delay(10);
+    }
+
+    return false;
 }
 
 au::Quantity<au::Degrees, double> Imu::get_rotation() {
-    auto raw_reading = au::degrees(this->raw.get_rotation());
-    auto corrected_reading = raw_reading * this->scalar;
-    return corrected_reading;
+    std::lock_guard<pros::Mutex> guard(this->mutex);
+
+    auto drift_time = au::milli(au::seconds)(static_cast<double>(pros::millis() - this->drift_start_time));
+
+    std::array<au::Quantity<au::Degrees, double>, max_imus> readings{};
+    size_t count = 0;
+
+    for (size_t i = 0; i < this->raw.size(); i++) {
+        if (this->excluded[i]) {
+            continue;
+        }
+
+        auto raw_reading = this->raw[i].get_rotation();
+
+        // a disconnected or calibrating imu returns an error code
+        if (raw_reading == PROS_ERR_F) {
+            continue;
+        }
+
+        auto corrected_reading = au::degrees(raw_reading) * this->scalar - this->drift_offsets[i] - this->drift_rates[i] * drift_time;
+        readings[count++] = corrected_reading;
+    }
+
+    if (count == 0) {
+        return this->last_rotation;
+    }
+
+    std::sort(readings.begin(), readings.begin() + count);
+    auto median = readings[count / 2];
+
+    // with two imus the median is ambiguous, trust the one closest to the last reading
+    if (count == 2 && readings[1] - readings[0] > this->fusion_tolerance) {
+        median = au::abs(readings[0] - this->last_rotation) <= au::abs(readings[1] - this->last_rotation) 
+            ? readings[0] 
+            : readings[1];
+    }
+
+    // average every imu that agrees with the median
+    au::Quantity<au::Degrees, double> sum = au::ZERO;
+    int32_t agreeing = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        if (au::abs(readings[i] - median) <= this->fusion_tolerance) {
+            sum += readings[i];
+            agreeing++;
+        }
+    }
+
+    this->last_rotation = sum / static_cast<double>(agreeing);
+    return this->last_rotation;
 }
 
 au::Quantity<au::Degrees, double> Imu::get_heading() {
-    auto raw_reading = au::degrees(this->raw.get_heading());
-    auto corrected_reading = raw_reading * this->scalar;
-    return corrected_reading;
+    auto rotation = this->get_rotation();
+    return au::fmod(au::fmod(rotation, au::degrees(360)) + au::degrees(360), au::degrees(360));
 }
 
 }
\ No newline at end of file
@@ -2,7 +2,11 @@
 #include "au/au.hpp"
 #include "pros/abstract_motor.hpp"
 #include "pros/motor_group.hpp"
+#include "pros/error.h"
+#include <algorithm>
+#include <cmath>
 #include <initializer_list>
+#include <mutex>
 
 
 namespace dlib {
@@ -24,40 +28,238 @@ MotorGroup::MotorGroup(MotorGroupConfig config) : raw(config.ports) {
 }
 
 void MotorGroup::move(const double power) {
-    this->raw.move(power);
+    // scaled rather than clamped, so both sides of a drive keep their ratio while derated
+    auto scale = this->voltage_limit / au::volts(12.0);
+    auto limited_power = std::clamp(power, -127.0, 127.0) * scale;
+
+    // joystick power is out of 127, which maps to 12V
+    this->commanded_voltage = au::volts(12.0) * (limited_power / 127);
+    this->raw.move(limited_power);
 }
 
 void MotorGroup::move_voltage(const au::Quantity<au::Volts, double> voltage) {
-    auto millivolts = voltage.in(au::milli(au::volts));
+    // scaled rather than clamped, so both sides of a drive keep their ratio while derated
+    auto scale = this->voltage_limit / au::volts(12.0);
+    auto limited_voltage = std::clamp(voltage, -au::volts(12.0), au::volts(12.0)) * scale;
+    this->commanded_voltage = limited_voltage;
+    auto millivolts = limited_voltage.in(au::milli(au::volts));
     this->raw.move_voltage(millivolts);
 }
 
+void MotorGroup::brake() {
+    this->commanded_voltage = au::ZERO;
+    this->raw.brake();
+}
+
+static uint8_t fault_flag(MotorFault fault) {
+    return static_cast<uint8_t>(fault);
+}
+
+// average of the readings within tolerance of their median, readings outside of it are added to the mask.
+// readings already in the mask are ignored. returns false if every reading is masked
+static bool robust_average(
+    const std::array<double, MotorGroupSample::capacity>& readings,
+    uint8_t count,
+    double tolerance,
+    uint32_t& mask,
+    double& average
+) {
+    std::array<double, MotorGroupSample::capacity> valid{};
+    uint8_t valid_count = 0;
+
+    for (uint8_t i = 0; i < count; i++) {
+        if (!(mask & (1u << i))) {
+            valid[valid_count++] = readings[i];
+        }
+    }
+
+    if (valid_count == 0) {
+        return false;
+    }
+
+    std::sort(valid.begin(), valid.begin() + valid_count);
+    double median = valid_count % 2 == 1 
+        ? valid[valid_count / 2] 
+        : (valid[valid_count / 2 - 1] + valid[valid_count / 2]) / 2;
+
+    double sum = 0;
+    uint8_t agreeing = 0;
+    uint32_t disagreeing_mask = 0;
+
+    for (uint8_t i = 0; i < count; i++) {
+        if (mask & (1u << i)) {
+            continue;
+        }
+
+        if (std::abs(readings[i] - median) <= tolerance) {
+            sum += readings[i];
+            agreeing++;
+        } else {
+            disagreeing_mask |= 1u << i;
+        }
+    }
+
+    // with two motors that disagree there is no way to tell which one is wrong, so use both
+    if (agreeing == 0) {
+        average = median;
+        return true;
+    }
+
+    mask |= disagreeing_mask;
+    average = sum / agreeing;
+    return true;
+}
+
 au::Quantity<au::Revolutions, double> MotorGroup::get_position() {
-    auto positions = this->raw.get_position_all();
-    double average = 0;
+    // read each motor by index, the *_all functions allocate a vector every call
+    std::array<double, MotorGroupSample::capacity> positions{};
+    uint8_t count = std::min<uint8_t>(this->raw.size(), MotorGroupSample::capacity);
+    uint32_t mask = 0;
+
+    for (uint8_t i = 0; i < count; i++) {
+        positions[i] = this->raw.get_position(i);
 
-    for (auto position : positions) {
-        average += position;
+        if (positions[i] == PROS_ERR_F) {
+            mask |= 1u << i;
+        }
     }
 
-    average /= positions.size();
+    double average = 0;
+    bool valid = robust_average(positions, count, this->health_config.position_tolerance.in(au::revolutions), mask, average);
 
-    auto revolutions = au::revolutions(average);
-    return revolutions;
+    std::lock_guard<pros::Mutex> guard(this->mutex);
+    if (valid) {
+        this->last_position = au::revolutions(average);
+    }
+
+    this->fault_mask = mask;
+    return this->last_position;
 }
 
 au::Quantity<au::Rpm, double> MotorGroup::get_velocity() {
-    auto rpms = this->raw.get_actual_velocity_all();
+    std::array<double, MotorGroupSample::capacity> rpms{};
+    uint8_t count = std::min<uint8_t>(this->raw.size(), MotorGroupSample::capacity);
+    uint32_t mask = 0;
+
+    for (uint8_t i = 0; i < count; i++) {
+        rpms[i] = this->raw.get_actual_velocity(i);
+
+        if (rpms[i] == PROS_ERR_F) {
+            mask |= 1u << i;
+        }
+    }
+
     double average = 0;
+    bool valid = robust_average(rpms, count, this->health_config.velocity_tolerance.in(au::rpm), mask, average);
+
+    std::lock_guard<pros::Mutex> guard(this->mutex);
+    if (valid) {
+        this->last_velocity = au::rpm(average);
+    }
 
-    for (auto rpm : rpms) {
-        average += rpm;
+    return this->last_velocity;
+}
+
+void MotorGroup::sample(MotorGroupSample& sample) {
+    sample.count = std::min<uint8_t>(this->raw.size(), MotorGroupSample::capacity);
+
+    std::array<double, MotorGroupSample::capacity> positions{};
+    std::array<double, MotorGroupSample::capacity> rpms{};
+    uint32_t position_mask = 0;
+    uint32_t velocity_mask = 0;
+
+    double current_sum = 0;
+    uint8_t current_count = 0;
+    double max_temperature = 0;
+
+    for (uint8_t i = 0; i < sample.count; i++) {
+        auto& motor = sample.motors[i];
+        motor = MotorSample{};
+
+        positions[i] = this->raw.get_position(i);
+        rpms[i] = this->raw.get_actual_velocity(i);
+        auto current = this->raw.get_current_draw(i);
+        auto temperature = this->raw.get_temperature(i);
+        auto voltage = this->raw.get_voltage(i);
+
+        if (positions[i] == PROS_ERR_F || rpms[i] == PROS_ERR_F || current == PROS_ERR || temperature == PROS_ERR_F || voltage == PROS_ERR) {
+            motor.faults |= fault_flag(MotorFault::Disconnected);
+            position_mask |= 1u << i;
+            velocity_mask |= 1u << i;
+            continue;
+        }
+
+        motor.position = au::revolutions(positions[i]);
+        motor.velocity = au::rpm(rpms[i]);
+        motor.current = au::milli(au::amperes)(static_cast<double>(current));
+        motor.temperature = au::celsius_qty(temperature);
+        motor.voltage = au::milli(au::volts)(static_cast<double>(voltage));
+
+        if (motor.temperature >= this->health_config.temperature_limit) {
+            motor.faults |= fault_flag(MotorFault::OverTemperature);
+        }
+
+        if (this->raw.is_over_current(i) == 1) {
+            motor.faults |= fault_flag(MotorFault::OverCurrent);
+        }
+
+        current_sum += motor.current.in(au::milli(au::amperes));
+        current_count++;
+        max_temperature = std::max(max_temperature, temperature);
+    }
+
+    double average_position = 0;
+    double average_rpm = 0;
+    bool position_valid = robust_average(positions, sample.count, this->health_config.position_tolerance.in(au::revolutions), position_mask, average_position);
+    bool velocity_valid = robust_average(rpms, sample.count, this->health_config.velocity_tolerance.in(au::rpm), velocity_mask, average_rpm);
+
+    sample.fault_mask = 0;
+    for (uint8_t i = 0; i < sample.count; i++) {
+        if ((position_mask | velocity_mask) & (1u << i) && !(sample.motors[i].faults & fault_flag(MotorFault::Disconnected))) {
+            sample.motors[i].faults |= fault_flag(MotorFault::Disagrees);
+        }
+
+        if (sample.motors[i].faults != fault_flag(MotorFault::None)) {
+            sample.fault_mask |= 1u << i;
+        }
     }
 
-    average /= rpms.size();
+    sample.average_current = au::milli(au::amperes)(current_count > 0 ? current_sum / current_count : 0.0);
+    sample.max_temperature = au::celsius_qty(max_temperature);
+
+    std::lock_guard<pros::Mutex> guard(this->mutex);
+    if (position_valid) {
+        this->last_position = au::revolutions(average_position);
+    }
+
+    if (velocity_valid) {
+        this->last_velocity = au::rpm(average_rpm);
+    }
+
+    sample.average_position = this->last_position;
+    sample.average_velocity = this->last_velocity;
+
+    this->fault_mask = sample.fault_mask;
+}
+
+uint32_t MotorGroup::get_fault_mask() const {
+    return this->fault_mask;
+}
+
+void MotorGroup::set_health_config(MotorHealthConfig config) {
+    this->health_config = config;
+}
+
+void MotorGroup::set_voltage_limit(au::Quantity<au::Volts, double> limit) {
+    this->voltage_limit = std::clamp(limit, au::volts(0.0), au::volts(12.0));
+}
+
+au::Quantity<au::Volts, double> MotorGroup::get_voltage_limit() const {
+    return this->voltage_limit;
+}
 
-    auto rpm = au::rpm(average);
-    return rpm;
+au::Quantity<au::Volts, double> MotorGroup::get_commanded_voltage() const {
+    return this->commanded_voltage;
 }
 
 }
\ No newline at end of file
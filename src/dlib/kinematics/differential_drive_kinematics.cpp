@@ -0,0 +1,83 @@
+#include "dlib/kinematics/differential_drive_kinematics.hpp"
+#include "au/au.hpp"
+#include <cmath>
+
+namespace dlib {
+
+// differential_drive_kinematics.cpp
+
+DifferentialDriveKinematics::DifferentialDriveKinematics(
+    au::Quantity<au::Meters, double> wheel_diameter,
+    double gear_ratio,
+    au::Quantity<au::Meters, double> track_width
+) :
+    wheel_diameter(wheel_diameter),
+    gear_ratio(gear_ratio),
+    track_width(track_width) {
+
+}
+
+au::Quantity<au::Meters, double> DifferentialDriveKinematics::revolutions_to_displacement(const au::Quantity<au::Revolutions, double> revolutions) const {
+    // not sure if there's a unit-safe way to do this
+    auto wheel_circumference = this->wheel_diameter.in(au::meters) * M_PI;
+    auto linear_distance = 
+        revolutions.in(au::revolutions) 
+        * wheel_circumference 
+        * this->gear_ratio;
+    
+    return au::meters(linear_distance);
+}
+
+au::Quantity<au::MetersPerSecond, double> DifferentialDriveKinematics::rpm_to_velocity(const au::Quantity<au::Rpm, double> rpm) const {
+    auto wheel_circumference = this->wheel_diameter.in(au::meters) * M_PI;
+    auto linear_velocity = 
+        rpm.in(au::rps) 
+        * wheel_circumference 
+        * this->gear_ratio;
+    
+    return au::meters_per_second(linear_velocity);
+}
+
+au::Quantity<au::Rpm, double> DifferentialDriveKinematics::velocity_to_rpm(const au::Quantity<au::MetersPerSecond, double> velocity) const {
+    auto wheel_circumference = this->wheel_diameter.in(au::meters) * M_PI;
+    auto motor_rps = 
+        velocity.in(au::meters_per_second) 
+        / (wheel_circumference * this->gear_ratio);
+
+    return au::rps(motor_rps);
+}
+
+ChassisSpeeds DifferentialDriveKinematics::to_chassis_speeds(const WheelSpeeds wheel_speeds) const {
+    auto linear = (wheel_speeds.left + wheel_speeds.right) / 2.0;
+
+    // the difference in side speeds over the track width is the rate of rotation
+    auto angular = au::radians_per_second(
+        (wheel_speeds.right - wheel_speeds.left).in(au::meters_per_second) 
+        / this->track_width.in(au::meters)
+    );
+
+    return {linear, angular};
+}
+
+WheelSpeeds DifferentialDriveKinematics::to_wheel_speeds(const ChassisSpeeds chassis_speeds) const {
+    auto half_difference = au::meters_per_second(
+        chassis_speeds.angular.in(au::radians_per_second) 
+        * this->track_width.in(au::meters) / 2.0
+    );
+
+    return {chassis_speeds.linear - half_difference, chassis_speeds.linear + half_difference};
+}
+
+au::Quantity<decltype(au::Radians{} / au::Meters{}), double> DifferentialDriveKinematics::curvature(const ChassisSpeeds chassis_speeds) const {
+    auto linear = chassis_speeds.linear.in(au::meters_per_second);
+
+    if (linear == 0) {
+        return au::ZERO;
+    }
+
+    return au::make_quantity<decltype(au::Radians{} / au::Meters{})>(
+        chassis_speeds.angular.in(au::radians_per_second) / linear
+    );
+}
+
+}
@@ -0,0 +1,65 @@
+#include "dlib/telemetry/cobs.hpp"
+
+namespace dlib {
+
+// cobs.cpp
+
+size_t cobs_encode(const uint8_t* input, size_t length, uint8_t* output) {
+    size_t write = 1;
+    size_t code_index = 0;
+    uint8_t code = 1;
+
+    for (size_t read = 0; read < length; read++) {
+        if (input[read] == 0) {
+            // a zero ends the block, its code is the distance to the zero
+            output[code_index] = code;
+            code_index = write++;
+            code = 1;
+        } else {
+            output[write++] = input[read];
+            code++;
+
+            // a full block of 254 non-zero bytes has no zero to replace
+            if (code == 0xFF) {
+                output[code_index] = code;
+                code_index = write++;
+                code = 1;
+            }
+        }
+    }
+
+    output[code_index] = code;
+
+    return write;
+}
+
+size_t cobs_decode(const uint8_t* input, size_t length, uint8_t* output) {
+    size_t read = 0;
+    size_t write = 0;
+
+    while (read < length) {
+        uint8_t code = input[read];
+
+        // the block's last byte is at read + code - 1, which has to be inside the input
+        if (code == 0 || read + code > length) {
+            return 0;
+        }
+        read++;
+
+        for (uint8_t i = 1; i < code; i++) {
+            if (input[read] == 0) {
+                return 0;
+            }
+            output[write++] = input[read++];
+        }
+
+        // every block but a full one, or the last, ended in a zero
+        if (code != 0xFF && read < length) {
+            output[write++] = 0;
+        }
+    }
+
+    return write;
+}
+
+}
@@ -0,0 +1,101 @@
+#include "dlib/telemetry/sd_logger.hpp"
+
+namespace dlib {
+
+// sd_logger.cpp
+
+bool SdLogger::start(const char* path) {
+    if (this->running) {
+        return true;
+    }
+
+    if (!pros::usd::is_installed()) {
+        return false;
+    }
+
+    this->file = std::fopen(path, "wb");
+    if (this->file == nullptr) {
+        return false;
+    }
+
+    TelemetryLogHeader header {
+        telemetry_log_magic,
+        telemetry_log_version,
+        sizeof(TelemetryRecord)
+    };
+    std::fwrite(&header, sizeof(header), 1, this->file);
+
+    this->running = true;
+    this->task_done = false;
+
+    this->task = std::make_unique<pros::Task>([this]() {
+        uint32_t last_sync = pros::millis();
+
+        while (this->running) {
+            // write full blocks while there are any, otherwise wait for more records
+            if (this->flush() < block_size) {
+                pros::delay(50);
+            }
+
+            // push the data out of the file's buffer every second so a power loss only costs a second
+            if (pros::millis() - last_sync >= 1000) {
+                std::fflush(this->file);
+                last_sync = pros::millis();
+            }
+        }
+
+        this->task_done = true;
+    }, TASK_PRIORITY_MIN + 1, TASK_STACK_DEPTH_DEFAULT, "sd logger");
+
+    return true;
+}
+
+bool SdLogger::log(const TelemetryRecord& record) {
+    if (!this->running) {
+        return false;
+    }
+
+    return this->buffer.push(record);
+}
+
+size_t SdLogger::flush() {
+    size_t count = this->buffer.pop(this->block, block_size);
+
+    if (count > 0) {
+        std::fwrite(this->block, sizeof(TelemetryRecord), count, this->file);
+    }
+
+    return count;
+}
+
+void SdLogger::stop() {
+    if (!this->running) {
+        return;
+    }
+
+    // let the task finish its current write before touching the file
+    this->running = false;
+    while (!this->task_done) {
+        pros::delay(5);
+    }
+    this->task = nullptr;
+
+    while (this->flush() > 0) {}
+
+    std::fclose(this->file);
+    this->file = nullptr;
+}
+
+bool SdLogger::is_running() const {
+    return this->running;
+}
+
+uint32_t SdLogger::get_dropped() const {
+    return this->buffer.get_dropped();
+}
+
+SdLogger::~SdLogger() {
+    this->stop();
+}
+
+}
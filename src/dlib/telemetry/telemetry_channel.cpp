@@ -0,0 +1,55 @@
+#include "dlib/telemetry/telemetry_channel.hpp"
+
+namespace dlib {
+
+// telemetry_channel.cpp
+
+// a function local array, so channels declared in any translation unit can register during static initialization
+static TelemetryChannelBase** channels() {
+    static TelemetryChannelBase* registered[telemetry_channel_capacity] = {};
+    return registered;
+}
+
+static size_t channel_count = 0;
+
+TelemetryChannelBase::TelemetryChannelBase(const char* name) : name(name) {
+    TelemetryRegistry::add(this);
+}
+
+bool TelemetryRegistry::add(TelemetryChannelBase* channel) {
+    if (channel_count >= telemetry_channel_capacity) {
+        return false;
+    }
+
+    channels()[channel_count++] = channel;
+    return true;
+}
+
+size_t TelemetryRegistry::size() {
+    return channel_count;
+}
+
+TelemetryChannelBase& TelemetryRegistry::get(size_t index) {
+    return *channels()[index];
+}
+
+// where the next drain_all starts
+static size_t next_channel = 0;
+
+size_t TelemetryRegistry::drain_all(TelemetryChannelBase::Visitor visitor, void* context, size_t limit) {
+    size_t total = 0;
+
+    for (size_t i = 0; i < channel_count && total < limit; i++) {
+        size_t index = (next_channel + i) % channel_count;
+        total += channels()[index]->drain(visitor, context, limit - total);
+
+        // this channel may still have values, start from it next time
+        if (total >= limit) {
+            next_channel = index;
+        }
+    }
+
+    return total;
+}
+
+}
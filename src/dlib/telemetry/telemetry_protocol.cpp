@@ -0,0 +1,55 @@
+#include "dlib/telemetry/telemetry_protocol.hpp"
+
+namespace dlib {
+
+// telemetry_protocol.cpp
+
+size_t write_varint(uint32_t value, uint8_t* output) {
+    size_t length = 0;
+
+    while (value >= 0x80) {
+        output[length++] = static_cast<uint8_t>(value) | 0x80;
+        value >>= 7;
+    }
+    output[length++] = static_cast<uint8_t>(value);
+
+    return length;
+}
+
+size_t read_varint(const uint8_t* input, size_t length, uint32_t& value) {
+    value = 0;
+
+    for (size_t i = 0; i < length && i < 5; i++) {
+        value |= static_cast<uint32_t>(input[i] & 0x7F) << (7 * i);
+
+        if ((input[i] & 0x80) == 0) {
+            return i + 1;
+        }
+    }
+
+    return 0;
+}
+
+uint32_t zigzag_encode(int32_t value) {
+    return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+}
+
+int32_t zigzag_decode(uint32_t value) {
+    return static_cast<int32_t>(value >> 1) ^ -static_cast<int32_t>(value & 1);
+}
+
+uint8_t telemetry_crc8(const uint8_t* data, size_t length) {
+    uint8_t crc = 0;
+
+    for (size_t i = 0; i < length; i++) {
+        crc ^= data[i];
+
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x80) ? static_cast<uint8_t>((crc << 1) ^ 0x07) : static_cast<uint8_t>(crc << 1);
+        }
+    }
+
+    return crc;
+}
+
+}
@@ -0,0 +1,150 @@
+#include "dlib/telemetry/telemetry_stream.hpp"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include "pros/apix.h"
+
+namespace dlib {
+
+// telemetry_stream.cpp
+
+TelemetryStream::TelemetryStream(TelemetryStreamConfig config) : config(config) {
+    for (size_t i = 0; i < telemetry_max_channels; i++) {
+        this->values[i] = 0;
+        this->sent[i] = 0;
+    }
+}
+
+int8_t TelemetryStream::add_channel(const char* name, const char* unit, float resolution) {
+    if (this->task != nullptr || this->channel_count >= telemetry_max_channels || resolution <= 0) {
+        return -1;
+    }
+
+    auto& channel = this->channels[this->channel_count];
+    std::snprintf(channel.name, sizeof(channel.name), "%s", name);
+    std::snprintf(channel.unit, sizeof(channel.unit), "%s", unit);
+    channel.resolution = resolution;
+
+    return static_cast<int8_t>(this->channel_count++);
+}
+
+void TelemetryStream::set(int8_t id, double value) {
+    if (id < 0 || static_cast<size_t>(id) >= this->channel_count) {
+        return;
+    }
+
+    // quantize here so the stream task only moves integers
+    double steps = std::round(value / this->channels[id].resolution);
+    steps = std::fmax(std::fmin(steps, INT32_MAX), INT32_MIN);
+
+    this->values[id].store(static_cast<int32_t>(steps), std::memory_order_relaxed);
+}
+
+void TelemetryStream::send_frame(uint8_t* frame, size_t length) {
+    frame[length] = telemetry_crc8(frame, length);
+    length++;
+
+    uint8_t encoded[cobs_max_encoded_length(telemetry_max_frame) + 1];
+    size_t encoded_length = cobs_encode(frame, length, encoded);
+    encoded[encoded_length++] = 0;
+
+    std::fwrite(encoded, 1, encoded_length, stdout);
+}
+
+void TelemetryStream::send_channels() {
+    uint8_t frame[telemetry_max_frame];
+
+    // end whatever terminal text came before, so the first description isn't merged with it
+    std::fputc(0, stdout);
+
+    for (size_t id = 0; id < this->channel_count; id++) {
+        auto& channel = this->channels[id];
+        size_t length = 0;
+
+        frame[length++] = static_cast<uint8_t>(TelemetryFrame::Channel);
+        frame[length++] = static_cast<uint8_t>(id);
+        std::memcpy(&frame[length], &channel.resolution, sizeof(float));
+        length += sizeof(float);
+
+        size_t name_length = std::strlen(channel.name) + 1;
+        std::memcpy(&frame[length], channel.name, name_length);
+        length += name_length;
+
+        size_t unit_length = std::strlen(channel.unit) + 1;
+        std::memcpy(&frame[length], channel.unit, unit_length);
+        length += unit_length;
+
+        this->send_frame(frame, length);
+    }
+}
+
+void TelemetryStream::send_sample() {
+    uint8_t frame[telemetry_max_frame];
+    size_t length = 0;
+
+    uint32_t timestamp = pros::millis();
+    bool key = this->config.key_interval <= 1 || this->samples % this->config.key_interval == 0;
+
+    if (key) {
+        frame[length++] = static_cast<uint8_t>(TelemetryFrame::KeySample);
+        std::memcpy(&frame[length], &timestamp, sizeof(uint32_t));
+        length += sizeof(uint32_t);
+    } else {
+        frame[length++] = static_cast<uint8_t>(TelemetryFrame::DeltaSample);
+        length += write_varint(timestamp - this->last_timestamp, &frame[length]);
+    }
+
+    frame[length++] = static_cast<uint8_t>(this->channel_count);
+
+    for (size_t id = 0; id < this->channel_count; id++) {
+        int32_t value = this->values[id].load(std::memory_order_relaxed);
+        int32_t encoded = key ? value : value - this->sent[id];
+
+        length += write_varint(zigzag_encode(encoded), &frame[length]);
+        this->sent[id] = value;
+    }
+
+    this->send_frame(frame, length);
+
+    this->last_timestamp = timestamp;
+    this->samples++;
+}
+
+void TelemetryStream::update() {
+    uint32_t now = pros::millis();
+
+    if (this->samples == 0 || now - this->last_announce >= this->config.announce_interval) {
+        this->send_channels();
+        this->last_announce = now;
+
+        // the next sample is a key sample, so a reader that just learned the channels can start decoding
+        this->samples = 0;
+    }
+
+    this->send_sample();
+    std::fflush(stdout);
+}
+
+void TelemetryStream::start() {
+    if (this->task != nullptr) {
+        return;
+    }
+
+    // write raw bytes, our frames do their own COBS encoding
+    pros::c::serctl(SERCTL_DISABLE_COBS, nullptr);
+
+    this->task = std::make_unique<pros::Task>([this]() {
+        uint32_t time = pros::millis();
+
+        while (true) {
+            this->update();
+            pros::Task::delay_until(&time, this->config.period);
+        }
+    }, TASK_PRIORITY_DEFAULT - 2, TASK_STACK_DEPTH_DEFAULT, "telemetry stream");
+}
+
+bool TelemetryStream::is_running() const {
+    return this->task != nullptr;
+}
+
+}
@@ -0,0 +1,23 @@
+#include "dlib/utilities/desaturate.hpp"
+#include "au/au.hpp"
+#include <algorithm>
+
+namespace dlib {
+
+// desaturate.cpp
+
+SideVoltages desaturate(
+    const SideVoltages voltages, 
+    const au::Quantity<au::Volts, double> max_voltage
+) {
+    auto largest = std::max(au::abs(voltages.left), au::abs(voltages.right));
+
+    if (largest <= max_voltage) {
+        return voltages;
+    }
+
+    double scale = max_voltage / largest;
+    return {voltages.left * scale, voltages.right * scale};
+}
+
+}
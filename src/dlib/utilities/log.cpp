@@ -0,0 +1,162 @@
+#include "dlib/utilities/log.hpp"
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include "api.h"
+
+namespace dlib {
+
+// log.cpp
+
+// any task can log, so pushes are serialized, the log task is the only consumer
+static RingBuffer<LogMessage, 64> queue;
+static pros::Mutex queue_mutex;
+static std::unique_ptr<pros::Task> log_task = nullptr;
+
+static const char* level_name(LogLevel level) {
+    switch (level) {
+        case LogLevel::Debug: return "debug";
+        case LogLevel::Info: return "info";
+        case LogLevel::Warning: return "warn";
+        case LogLevel::Error: return "error";
+    }
+    return "";
+}
+
+static size_t format_argument(const LogArgument& argument, const char* spec, size_t spec_length, char* output, size_t size) {
+    int length = 0;
+
+    switch (argument.type) {
+        case LogArgument::Type::Integer:
+            length = std::snprintf(output, size, "%lld", static_cast<long long>(argument.integer));
+            break;
+        case LogArgument::Type::Unsigned:
+            length = std::snprintf(output, size, "%llu", static_cast<unsigned long long>(argument.unsigned_integer));
+            break;
+        case LogArgument::Type::Double:
+            if (spec_length > 0 && spec_length < 8) {
+                // a spec like .2f becomes %.2f
+                char format[10] = "%";
+                std::memcpy(&format[1], spec, spec_length);
+                format[spec_length + 1] = '\0';
+                length = std::snprintf(output, size, format, argument.floating);
+            } else {
+                length = std::snprintf(output, size, "%g", argument.floating);
+            }
+            break;
+        case LogArgument::Type::String:
+            length = std::snprintf(output, size, "%s", argument.string ? argument.string : "(null)");
+            break;
+    }
+
+    if (length < 0) {
+        return 0;
+    }
+    return static_cast<size_t>(length) < size ? length : size - 1;
+}
+
+size_t Log::format(const LogMessage& message, char* output, size_t size) {
+    if (size == 0) {
+        return 0;
+    }
+
+    size_t length = 0;
+    size_t argument = 0;
+    const char* read = message.format;
+
+    while (*read != '\0' && length + 1 < size) {
+        if (read[0] == '{' && read[1] == '{') {
+            output[length++] = '{';
+            read += 2;
+            continue;
+        }
+        if (read[0] == '}' && read[1] == '}') {
+            output[length++] = '}';
+            read += 2;
+            continue;
+        }
+
+        const char* close = read[0] == '{' ? std::strchr(read, '}') : nullptr;
+        if (close == nullptr) {
+            output[length++] = *read++;
+            continue;
+        }
+
+        const char* spec = read + 1;
+        size_t spec_length = close - spec;
+        if (spec_length > 0 && spec[0] == ':') {
+            spec++;
+            spec_length--;
+        }
+
+        if (argument < message.argument_count) {
+            length += format_argument(message.arguments[argument++], spec, spec_length, &output[length], size - length);
+        }
+
+        read = close + 1;
+    }
+
+    output[length] = '\0';
+    return length;
+}
+
+void Log::emit(const LogMessage& message) {
+    char line[log_max_length];
+
+    int prefix = std::snprintf(line, sizeof(line), "[%lu %s] ", static_cast<unsigned long>(message.timestamp), level_name(message.level));
+    size_t length = prefix > 0 ? prefix : 0;
+
+    length += format(message, &line[length], sizeof(line) - length - 1);
+    line[length++] = '\n';
+
+    std::fwrite(line, 1, length, stdout);
+}
+
+void Log::submit(const LogMessage& message) {
+    if (mode == LogMode::Immediate) {
+        emit(message);
+        return;
+    }
+
+    std::lock_guard<pros::Mutex> guard(queue_mutex);
+    queue.push(message);
+}
+
+void Log::start(LogMode mode) {
+    Log::mode = mode;
+
+    if (mode != LogMode::Deferred || log_task != nullptr) {
+        return;
+    }
+
+    log_task = std::make_unique<pros::Task>([]() {
+        LogMessage messages[8];
+
+        while (true) {
+            size_t count;
+            while ((count = queue.pop(messages, 8)) > 0) {
+                for (size_t i = 0; i < count; i++) {
+                    emit(messages[i]);
+                }
+            }
+
+            std::fflush(stdout);
+            pros::delay(20);
+        }
+    }, TASK_PRIORITY_MIN + 1, TASK_STACK_DEPTH_DEFAULT, "log");
+}
+
+void Log::set_level(LogLevel level) {
+    minimum_level = level;
+}
+
+uint32_t Log::get_dropped() {
+    return queue.get_dropped();
+}
+
+uint32_t Log::timestamp() {
+    return pros::millis();
+}
+
+}
@@ -0,0 +1,36 @@
+#include "dlib/utilities/motion_result.hpp"
+#include "dlib/utilities/log.hpp"
+
+namespace dlib {
+
+// motion_result.cpp
+
+void MotionSummary::reset() {
+    *this = MotionSummary{};
+}
+
+void MotionSummary::print() const {
+    log_info(
+        "motions: {} settled: {} timed out: {} stalled: {} total time: {:.2f}s slowest: #{} ({:.2f}s)",
+        motions, settled, timed_out, stalled, total_time.in(au::seconds), slowest_motion, slowest_time.in(au::seconds)
+    );
+}
+
+void MotionSummary::record(au::Quantity<au::Seconds, double> elapsed_time, SettleState exit_state) {
+    switch (exit_state) {
+        case SettleState::Settled: settled++; break;
+        case SettleState::TimedOut: timed_out++; break;
+        case SettleState::Stalled: stalled++; break;
+        case SettleState::Running: break;
+    }
+
+    if (elapsed_time > slowest_time) {
+        slowest_time = elapsed_time;
+        slowest_motion = motions;
+    }
+
+    total_time += elapsed_time;
+    motions++;
+}
+
+}
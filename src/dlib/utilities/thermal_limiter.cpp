@@ -0,0 +1,87 @@
+#include "dlib/utilities/thermal_limiter.hpp"
+#include "au/au.hpp"
+#include <algorithm>
+
+namespace dlib {
+
+// thermal_limiter.cpp
+
+ThermalLimiter::ThermalLimiter(ThermalLimiterConfig config) : config(config) {
+
+}
+
+double ThermalLimiter::update(au::Quantity<au::Celsius, double> temperature, au::Quantity<au::Seconds, double> period) {
+    if (!this->has_reading) {
+        this->last_temperature = temperature;
+        this->has_reading = true;
+    }
+
+    // the reading jumps a whole step at a time, so the rate is a step over the time spent at the last reading
+    this->time_since_step += period;
+
+    if (temperature != this->last_temperature) {
+        auto step = temperature - this->last_temperature;
+        int direction = step > au::ZERO ? 1 : -1;
+
+        // the first step, or a step back the other way (e.g. flickering at a boundary), only starts an interval
+        if (direction == this->step_direction) {
+            this->last_step = step;
+            this->step_interval = this->time_since_step;
+        } else {
+            this->last_step = au::ZERO;
+        }
+
+        this->step_direction = direction;
+        this->last_temperature = temperature;
+        this->time_since_step = au::ZERO;
+    }
+
+    // once the next step is overdue the motor must be heating slower, so the rate falls off
+    if (this->last_step == au::ZERO) {
+        this->temperature_rate = au::ZERO;
+    } else {
+        this->temperature_rate = this->last_step / std::max(this->step_interval, this->time_since_step);
+    }
+
+    // only predict heating, a cooling motor is limited by where it is now
+    decltype(this->temperature_rate) rising_rate = au::ZERO;
+    if (this->temperature_rate > au::ZERO) {
+        rising_rate = this->temperature_rate;
+    }
+
+    this->predicted_temperature = temperature + rising_rate * config.prediction_horizon;
+
+    double progress = 
+        (this->predicted_temperature - config.soft_limit) 
+        / (config.hard_limit - config.soft_limit);
+    progress = std::clamp(progress, 0.0, 1.0);
+
+    double target_scale = 1 - progress * (1 - config.minimum_scale);
+
+    double max_change = config.max_scale_rate * period.in(au::seconds);
+    this->scale += std::clamp(target_scale - this->scale, -max_change, max_change);
+
+    return this->scale;
+}
+
+au::Quantity<au::Celsius, double> ThermalLimiter::get_predicted_temperature() const {
+    return this->predicted_temperature;
+}
+
+double ThermalLimiter::get_scale() const {
+    return this->scale;
+}
+
+void ThermalLimiter::reset() {
+    this->has_reading = false;
+    this->last_temperature = au::ZERO;
+    this->time_since_step = au::ZERO;
+    this->step_interval = au::ZERO;
+    this->last_step = au::ZERO;
+    this->step_direction = 0;
+    this->temperature_rate = au::ZERO;
+    this->predicted_temperature = au::ZERO;
+    this->scale = 1;
+}
+
+}
@@ -7,12 +7,23 @@
 
 using namespace au;
 
+// passes the sticks straight through like the old arcade code, tune the shaping from here
+dlib::DriverControlConfig driver_control_config {
+	{0, 0},		// throttle deadband & expo
+	{0, 0},		// turn deadband & expo
+	0.5,		// turn scale
+	0.91,		// right side scale, the drive pulls to the right
+	ZERO		// slew rate (volts per second), zero is no slew limiting
+};
+
 dlib::ChassisConfig chassis_config {
 	{-12,-13,-14},
 	{19,18,17},
 	pros::MotorGearset::blue,
 	rpm(400),
-	inches(3.25)
+	inches(3.25),
+	inches(11.5),	// track width, center of the left wheels to center of the right wheels
+	driver_control_config
 };
 
 dlib::Timer timer {};
@@ -31,10 +42,13 @@ dlib::PidConfig linear_pid_config {
 	volts(12)
 };
 
-dlib::ErrorDerivativeSettler<Meters> linear_pid_settler {
-	inches(1),
-	meters_per_second(.1)
-};
+dlib::Settler<Meters> linear_pid_settler {{
+	inches(1),				// error threshold
+	meters_per_second(.1),	// derivative threshold
+	milli(seconds)(40.0),	// time within the thresholds to settle
+	seconds(3),				// timeout
+	meters_per_second(.02)	// stall velocity
+}};
 
 dlib::PidConfig angular_pid_config {
 	{
@@ -52,15 +66,21 @@ dlib::PidConfig precise_angular_pid_config {
 	volts(12)
 };
 
-dlib::ErrorDerivativeSettler<Degrees> angular_pid_settler {
+dlib::Settler<Degrees> angular_pid_settler {{
 	degrees(3),
-	degrees_per_second(20)
-};
+	degrees_per_second(20),
+	milli(seconds)(40.0),
+	seconds(2),
+	degrees_per_second(5)
+}};
 
-dlib::ErrorDerivativeSettler<Degrees> precise_angular_pid_settler {
+dlib::Settler<Degrees> precise_angular_pid_settler {{
 	degrees(1.5),
-	degrees_per_second(10)
-};
+	degrees_per_second(10),
+	milli(seconds)(60.0),
+	seconds(2),
+	degrees_per_second(5)
+}};
 
 dlib::Feedforward<Meters> linear_feedforward {
 	{
@@ -90,16 +110,43 @@ dlib::PidConfig angular_feedforward_pid_config {
 	volts(12)
 };
 
-dlib::ErrorDerivativeSettler<Meters> linear_feedforward_settler {
+dlib::Settler<Meters> linear_feedforward_settler {{
 	inches(1),
-	meters_per_second(.1)
-};
+	meters_per_second(.1),
+	milli(seconds)(40.0),
+	seconds(3),
+	meters_per_second(.02)
+}};
 
-dlib::ErrorDerivativeSettler<Degrees> angular_feedforward_settler {
+dlib::Settler<Degrees> angular_feedforward_settler {{
 	degrees(3),
-	degrees_per_second(20)
+	degrees_per_second(20),
+	milli(seconds)(40.0),
+	seconds(2),
+	degrees_per_second(5)
+}};
+
+// inner velocity loop for move_cascade, shared by both sides of the drive
+dlib::VelocityControllerConfig drive_velocity_config {
+	{
+		1.300052053471457,
+		6.092168652842858,
+		1.25
+	},
+	{
+		{2, 0, 0},
+		volts(12)
+	}
+};
+// keeps move_pid on its starting heading, the max voltage caps how hard it can steer
+dlib::PidConfig heading_hold_pid_config {
+	{
+		12,
+		0,
+		0.5
+	},
+	volts(4)
 };
-
 
 Intake intake {
 	-15,
@@ -107,6 +154,10 @@ Intake intake {
 	-10
 };
 
+ColorSortConfig color_sort_config {
+	9	// optical sensor port
+};
+
 Pneumatics pneumatics {
 	'A',
 	'B',
@@ -130,32 +181,11 @@ Robot robor = {
 	angular_feedforward_pid_config,
 	linear_feedforward_settler,
 	angular_feedforward_settler,
+	drive_velocity_config,
+	drive_velocity_config,
+	heading_hold_pid_config,
 };
 
-void initialize() {
-	robor.initialize();
-	initialize_brain();
-	robor.start_odom();
-
-	robor.chassis.left_motors.raw.tare_position_all();
-	robor.chassis.right_motors.raw.tare_position_all();
-
-	pros::Task print_coordinates([&](){
-		while(true){
-			// SCREEN TASK -- Prints coordinates to our GUI
-			dlib::Pose2d pose = robor.odom.get_position();
-			print_coords(robor);
-			// battery update for gui 
-			update_battery_percent();	
-			pros::delay(20);
-		}
-});
-}
-
-void disabled() {}
-
-void competition_initialize() {}
-
 // autons start here:
 void left_elim(void){
 
@@ -177,53 +207,107 @@ void skills(void){
 
 }
 
-void run_auton(){
-	if(get_selected() == 1){
-		left_elim();
-	}
-	else if(get_selected() == 2){
-		right_elim();
-	}
-	else if(get_selected() == 3){
-		left_elim();
-	}
-	else if(get_selected() == 4){
-		right_elim();
-	}
-	else if(get_selected() == 5){
-		left_wp();
-	}
-	else if(get_selected() == 6){
-		right_wp();
-	}
-	else if(get_selected() == 7){
-		left_wp();
-	}
-	else if(get_selected() == 8){
-		right_wp();
-	}
-	else if(get_selected() == 9){
-		skills();
-	}
+// every routine shown on the selector, grouped onto pages by alliance
+void register_autons(){
+	register_auton({"Red Ring Elim", AutonCategory::Red, left_elim});
+	register_auton({"Red Solo WP", AutonCategory::Red, left_wp});
+	register_auton({"Red Goal Elim", AutonCategory::Red, right_elim});
+
+	register_auton({"Blue Left Elim", AutonCategory::Blue, left_elim});
+	register_auton({"Blue Solo WP", AutonCategory::Blue, right_wp});
+	register_auton({"Blue Right Elim", AutonCategory::Blue, right_elim});
+
+	register_auton({"Risky Skills", AutonCategory::Skills, skills});
+	register_auton({"Safe Skills", AutonCategory::Skills, skills});
+
+	// color sort keeps the selected routine's alliance
+	on_auton_selected([](const Auton& auton){
+		robor.intake.set_alliance(get_auton_alliance(auton));
+	});
 }
 
+void initialize() {
+	// format log messages on a background task, so logging from a control loop costs a copy
+	dlib::Log::start(dlib::LogMode::Deferred);
+	robor.initialize();
+	register_autons();
+	initialize_brain();
+	robor.start_logging();
+	// robor.start_streaming(); // binary telemetry over usb, replaces the terminal output
+	robor.start_odom();
+	robor.start_intake();
+	robor.start_color_sort(color_sort_config);
+	robor.start_power_management();
+
+	robor.chassis.left_motors.raw.tare_position_all();
+	robor.chassis.right_motors.raw.tare_position_all();
+
+	// SCREEN TASK -- coordinates & battery on the GUI, only redrawn when they change
+	start_dashboard(robor);
+
+#if DLIB_TELEMETRY
+	// debug telemetry channels are formatted here, off of the control tasks
+	// half the log queue per log task cycle, so the values never crowd out other messages
+	pros::Task print_telemetry([](){
+		while(true){
+			dlib::TelemetryRegistry::drain_all([](const char* name, uint32_t timestamp, double value, void*){
+				dlib::log_debug("{} {} {}", timestamp, name, value);
+			}, nullptr, 32);
+			pros::delay(20);
+		}
+	}, TASK_PRIORITY_MIN + 1, TASK_STACK_DEPTH_DEFAULT, "telemetry printer");
+#endif
+}
+
+void disabled() {
+	// measure gyro drift once the robot sits still, it's often being placed or still coasting from auton
+	robor.imu.measure_drift(seconds(2.0));
+}
+
+void competition_initialize() {}
+
 void test_mp(){
 	timer.reset();
 	while(true){
 		double voltage = timer.get_elapsed_time().in(milli(seconds)) * 2.0;
 		robor.chassis.move_voltage(milli(volts)(voltage));
-		std::cout << timer.get_elapsed_time().in(milli(seconds)) << "," << voltage << "," << robor.chassis.forward_motor_displacement().in(meters) << "," << robor.chassis.forward_motor_velocity().in(meters_per_second) << std::endl;
+		dlib::log_debug("{},{},{},{}", timer.get_elapsed_time().in(milli(seconds)), voltage, robor.chassis.forward_motor_displacement().in(meters), robor.chassis.forward_motor_velocity().in(meters_per_second));
 		pros::delay(20);
 	}
 }
 
+void tune_pid(){
+	// relay autotune for a starting point, then refine it by running real moves
+	dlib::PidGains angular_gains = robor.autotune_angular({volts(6), degrees(0.5)});
+
+	dlib::GainSearchConfig angular_search_config {angular_gains};
+	angular_gains = robor.refine_angular_gains(angular_search_config);
+
+	// each refine restores the old gains when it finishes, so apply what it found
+	robor.angular_pid.set_gains(angular_gains);
+
+	dlib::PidGains linear_gains = robor.autotune_linear({volts(4), inches(0.25)});
+
+	dlib::GainSearchConfig linear_search_config {linear_gains};
+	linear_gains = robor.refine_linear_gains(linear_search_config);
+
+	robor.linear_pid.set_gains(linear_gains);
+}
+
 void autonomous() { // all coords are in meters btw
-	//test_mp(); // runs the auton that is selected on the gui
+	//run_selected_auton(); // runs the auton that is selected on the gui
+	//test_mp();
+	//tune_pid(); // prints tuned gains to the terminal & uses them for the rest of the run
+	robor.motion_summary.reset();
+	robor.clear_path();
+
 	robor.turn_absolute(90);
 	robor.turn_absolute(180);
 	robor.turn_absolute(15);
 	robor.turn_absolute(25);
 	robor.turn_absolute(40);
+
+	robor.motion_summary.print();
 }
 
 bool nanner = false;
@@ -247,6 +331,10 @@ void opcontrol() {
 			robor.intake.direction = -1;
 		}
 
+		if(master.get_digital_new_press(DIGITAL_B)){
+			robor.intake.toggle_color_sort();
+		}
+
 		if(master.get_digital_new_press(DIGITAL_A)){
 			nanner = !nanner;
 			pneumatics.set_nanner(nanner);
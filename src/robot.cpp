@@ -1,36 +1,58 @@
 #include "robot.hpp"
 
+DLIB_TELEMETRY_CHANNEL(move_pid_voltage, double);
+DLIB_TELEMETRY_CHANNEL(move_pid_heading_correction, double);
+DLIB_TELEMETRY_CHANNEL(turn_voltage, double);
+
 void Robot::initialize(){
+    // calibrate in the background while everything else initializes, motion commands wait for it to finish
+    imu.start_calibration();
+
     chassis.initialize();
 
     chassis.left_motors.raw.set_gearing_all(pros::E_MOTOR_GEAR_BLUE);
     chassis.right_motors.raw.set_gearing_all(pros::E_MOTOR_GEAR_BLUE);
-
-    imu.initialize();
 }
 
-void Robot::move_pid(Quantity<Meters, double> displacement) {
+dlib::MotionResult<Meters> Robot::move_pid(Quantity<Meters, double> displacement) {
+    imu.wait_until_calibrated();
+
     auto start_displacement = chassis.forward_motor_displacement();
     auto target_displacement = dlib::relative_target(start_displacement, displacement);
+    auto target_heading = imu.get_rotation();
     
     linear_pid.reset();
     linear_pid_settler.reset();
+    heading_hold_pid.reset();
+    dlib::MotionTracker<Meters> tracker;
 
-    while (!linear_pid_settler.is_settled(linear_pid.get_error(), linear_pid.get_derivative())) {
-        auto error = dlib::linear_error(target_displacement, chassis.forward_motor_displacement());
+    while (!linear_pid_settler.is_done()) {
+        auto sample = sample_motion();
+        auto error = dlib::linear_error(target_displacement, sample.forward_displacement());
         auto voltage = linear_pid.update(error, milli(seconds)(20));
-        std::cout << voltage << std::endl;
-        chassis.move_voltage(voltage);
+
+        // steer back towards the starting heading with a differential correction
+        auto heading_error = dlib::angular_error(target_heading, sample.rotation);
+        auto correction = heading_hold_pid.update(heading_error, milli(seconds)(20));
+        chassis.arcade_voltage(voltage, -correction);
+        DLIB_TELEMETRY_RECORD(move_pid_voltage, voltage.in(volts));
+        DLIB_TELEMETRY_RECORD(move_pid_heading_correction, correction.in(volts));
+
+        tracker.update(error, milli(seconds)(20));
+        auto state = linear_pid_settler.update(error, linear_pid.get_derivative(), sample.forward_velocity(), milli(seconds)(20));
+        log_tick(dlib::TelemetryController::LinearPid, sample, target_displacement.in(meters), 0, error.in(meters), state);
         pros::delay(20);
     }
     chassis.brake();
+
+    return record_motion(tracker.finish(linear_pid_settler.get_state()));
 }
 
-void Robot::move_pid(double displacement) {
-    move_pid(meters(displacement));
+dlib::MotionResult<Meters> Robot::move_pid(double displacement) {
+    return move_pid(meters(displacement));
 }
 
-void Robot::move_feedforward(double displacement, double max_velocity){
+dlib::MotionResult<Meters> Robot::move_feedforward(double displacement, double max_velocity){
     auto start_displacement = chassis.forward_motor_displacement();
     dlib::TrapezoidProfile<Meters> profile {
         meters_per_second_squared(3),
@@ -41,6 +63,7 @@ void Robot::move_feedforward(double displacement, double max_velocity){
 
     linear_feedforward_pid.reset();
     linear_pid_settler.reset();
+    dlib::MotionTracker<Meters> tracker;
 
     auto elapsed_time = 0;
     auto current_time = pros::millis();
@@ -52,11 +75,14 @@ void Robot::move_feedforward(double displacement, double max_velocity){
 
         auto setpoint = profile.calculate(milli(seconds)(elapsed_time));
 
-        auto current_position = chassis.forward_motor_displacement();
+        auto sample = sample_motion();
+        auto current_position = sample.forward_displacement();
         auto target_position = dlib::relative_target(start_displacement, setpoint.position);
 
         auto error = dlib::linear_error(target_position, current_position);
 
+        tracker.update(error, milli(seconds)(20));
+
         auto pid_voltage = linear_feedforward_pid.update(error, milli(seconds)(20));
         auto ff_voltage = linear_feedforward.calculate(setpoint.velocity, setpoint.acceleration);
         
@@ -64,74 +90,172 @@ void Robot::move_feedforward(double displacement, double max_velocity){
             chassis.move_voltage(volts(0));
         }
 
+        // the profile always runs to completion, the last record says how the motion ended
         if(profile.stage(milli(seconds)(elapsed_time)) == dlib::TrapezoidProfileStage::Done){
+            log_tick(dlib::TelemetryController::LinearFeedforward, sample, target_position.in(meters), setpoint.velocity.in(meters_per_second), error.in(meters), dlib::SettleState::Settled);
             break;
         }
 
-        std::cout << elapsed_time << "," << setpoint.velocity.in(meters_per_second) << "," << chassis.forward_motor_velocity().in(meters_per_second) << "\n";
-
         chassis.move_voltage(ff_voltage + pid_voltage);
+        log_tick(dlib::TelemetryController::LinearFeedforward, sample, target_position.in(meters), setpoint.velocity.in(meters_per_second), error.in(meters), dlib::SettleState::Running);
         
         pros::delay(20);
     }
     chassis.move_voltage(volts(0));
+
+    // the profile always runs to completion
+    return record_motion(tracker.finish(dlib::SettleState::Settled));
 }
 
-void Robot::turn_absolute(Quantity<Degrees, double> heading) {
+dlib::MotionResult<Meters> Robot::move_cascade(double displacement, double max_velocity) {
+    auto start_displacement = chassis.forward_motor_displacement();
+    auto target_displacement = dlib::relative_target(start_displacement, meters(displacement));
+    dlib::TrapezoidProfile<Meters> profile {
+        meters_per_second_squared(3),
+        meters_per_second_squared(3),
+        meters_per_second(max_velocity),
+        meters(displacement)
+    };
+
+    left_velocity_controller.reset();
+    right_velocity_controller.reset();
+    linear_feedforward_settler.reset();
+    dlib::MotionTracker<Meters> tracker;
+
+    auto start_time = pros::millis();
+    auto velocity_target = meters_per_second(0.0);
+    uint32_t ticks = 0;
+
+    // the inner velocity loops run every 10ms, the outer position loop every other tick
+    while (!linear_feedforward_settler.is_done()) {
+        auto elapsed_time = milli(seconds)(static_cast<double>(pros::millis() - start_time));
+        auto setpoint = profile.calculate(elapsed_time);
+        auto sample = sample_motion();
+
+        if (ticks % 2 == 0) {
+            auto target_position = dlib::relative_target(start_displacement, setpoint.position);
+            auto error = dlib::linear_error(target_position, sample.forward_displacement());
+
+            velocity_target = setpoint.velocity + meters_per_second(cascade_position_gain * error.in(meters));
+
+            // once the profile is done, hold the final position until the settler finishes
+            if (profile.stage(elapsed_time) == dlib::TrapezoidProfileStage::Done) {
+                auto final_error = dlib::linear_error(target_displacement, sample.forward_displacement());
+                tracker.update(final_error, milli(seconds)(20));
+                linear_feedforward_settler.update(final_error, -sample.forward_velocity(), sample.forward_velocity(), milli(seconds)(20));
+            } else {
+                tracker.update(error, milli(seconds)(20));
+            }
+        }
+
+        auto left_voltage = left_velocity_controller.update(velocity_target, setpoint.acceleration, sample.left_velocity, milli(seconds)(10));
+        auto right_voltage = right_velocity_controller.update(velocity_target, setpoint.acceleration, sample.right_velocity, milli(seconds)(10));
+        chassis.tank_voltage(left_voltage, right_voltage);
+
+        auto target_position = dlib::relative_target(start_displacement, setpoint.position);
+        auto error = dlib::linear_error(target_position, sample.forward_displacement());
+        log_tick(dlib::TelemetryController::LinearCascade, sample, target_position.in(meters), velocity_target.in(meters_per_second), error.in(meters), linear_feedforward_settler.get_state());
+
+        ticks++;
+        pros::delay(10);
+    }
+    chassis.brake();
+
+    return record_motion(tracker.finish(linear_feedforward_settler.get_state()));
+}
+
+dlib::MotionResult<Degrees> Robot::turn_absolute(Quantity<Degrees, double> heading) {
+    imu.wait_until_calibrated();
+
     angular_pid.reset();
     angular_pid_settler.reset();
+    dlib::MotionTracker<Degrees> tracker;
 
-    while (!angular_pid_settler.is_settled(angular_pid.get_error(), angular_pid.get_derivative())) {
-        auto error = dlib::angular_error(heading, imu.get_rotation());
+    while (!angular_pid_settler.is_done()) {
+        auto sample = sample_motion();
+        auto error = dlib::angular_error(heading, sample.rotation);
         auto voltage = angular_pid.update(error, milli(seconds)(20));
         chassis.turn_voltage(-voltage);
+        DLIB_TELEMETRY_RECORD(turn_voltage, voltage.in(volts));
+        tracker.update(error, milli(seconds)(20));
+        auto state = angular_pid_settler.update(error, angular_pid.get_derivative(), sample.angular_velocity, milli(seconds)(20));
+        log_tick(dlib::TelemetryController::AngularPid, sample, heading.in(degrees), 0, error.in(degrees), state);
         pros::delay(20);
     }
     chassis.brake();
+
+    return record_motion(tracker.finish(angular_pid_settler.get_state()));
 }
 
-void Robot::turn_absolute(double heading) {
-    turn_absolute(degrees(heading));
+dlib::MotionResult<Degrees> Robot::turn_absolute(double heading) {
+    return turn_absolute(degrees(heading));
 }
 
-void Robot::turn_relative(Quantity<Degrees, double> heading) {
+dlib::MotionResult<Degrees> Robot::turn_relative(Quantity<Degrees, double> heading) {
+    imu.wait_until_calibrated();
+
     auto start_heading = imu.get_rotation();
     auto target_heading = dlib::relative_target(start_heading, heading);
 
     angular_pid.reset();
     angular_pid_settler.reset();
+    dlib::MotionTracker<Degrees> tracker;
 
-    while(!angular_pid_settler.is_settled(angular_pid.get_error(), angular_pid.get_derivative())) {
-        auto error = dlib::angular_error(target_heading, imu.get_rotation());
+    while(!angular_pid_settler.is_done()) {
+        auto sample = sample_motion();
+        auto error = dlib::angular_error(target_heading, sample.rotation);
         auto voltage = angular_pid.update(error, milli(seconds)(20));
         chassis.turn_voltage(-voltage);
+        DLIB_TELEMETRY_RECORD(turn_voltage, voltage.in(volts));
+        tracker.update(error, milli(seconds)(20));
+        auto state = angular_pid_settler.update(error, angular_pid.get_derivative(), sample.angular_velocity, milli(seconds)(20));
+        log_tick(dlib::TelemetryController::AngularPid, sample, target_heading.in(degrees), 0, error.in(degrees), state);
         pros::delay(20);
     }
     chassis.brake();
+
+    return record_motion(tracker.finish(angular_pid_settler.get_state()));
 }
 
-void Robot::turn_relative(double heading) {
-    turn_relative(degrees(heading));
+dlib::MotionResult<Degrees> Robot::turn_relative(double heading) {
+    return turn_relative(degrees(heading));
 }
 
-void Robot::turn_precise(Quantity<Degrees, double> heading) {
+dlib::MotionResult<Degrees> Robot::turn_precise(Quantity<Degrees, double> heading) {
+    imu.wait_until_calibrated();
+
     precise_angular_pid.reset();
     precise_angular_pid_settler.reset();
+    dlib::MotionTracker<Degrees> tracker;
 
-    while (!precise_angular_pid_settler.is_settled(precise_angular_pid.get_error(), precise_angular_pid.get_derivative())) {
-        auto error = dlib::angular_error(heading, imu.get_rotation());
+    while (!precise_angular_pid_settler.is_done()) {
+        auto sample = sample_motion();
+        auto error = dlib::angular_error(heading, sample.rotation);
         auto voltage = precise_angular_pid.update(error, milli(seconds)(20));
+        tracker.update(error, milli(seconds)(20));
+        auto state = precise_angular_pid_settler.update(error, precise_angular_pid.get_derivative(), sample.angular_velocity, milli(seconds)(20));
+        log_tick(dlib::TelemetryController::PreciseAngularPid, sample, heading.in(degrees), 0, error.in(degrees), state);
         pros::delay(20);
     }
     chassis.brake();
+
+    return record_motion(tracker.finish(precise_angular_pid_settler.get_state()));
 }
 
-void Robot::turn_precise(double heading) {
-    turn_absolute(degrees(heading));
+dlib::MotionResult<Degrees> Robot::turn_precise(double heading) {
+    return turn_absolute(degrees(heading));
 }
 
-void Robot::move(double x, double y, double max_velocity, bool reverse, bool precise_turn) {
+dlib::MotionResult<Meters> Robot::move(double x, double y, double max_velocity, bool reverse, bool precise_turn) {
     auto point = dlib::Vector2d(meters(x),meters(y));
+
+    // the path starts wherever the robot was before its first move
+    if(path_length == 0){
+        auto pose = odom.get_position();
+        add_path_point(pose.x.in(meters), pose.y.in(meters));
+    }
+    add_path_point(x, y);
+
     if(precise_turn)
         turn_with_precision(x,y,reverse);
     else
@@ -140,19 +264,256 @@ void Robot::move(double x, double y, double max_velocity, bool reverse, bool pre
     if(reverse){
         displacement = -displacement;
     }
-    move_pid(displacement.in(meters));
+    return move_pid(displacement.in(meters));
+}
+
+void Robot::clear_path() {
+    path_version.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    path_length.store(0, std::memory_order_relaxed);
+
+    path_version.fetch_add(1, std::memory_order_release);
+}
+
+void Robot::add_path_point(double x, double y) {
+    // odd while writing, so the field map never keeps a half shifted copy
+    path_version.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    size_t length = path_length.load(std::memory_order_relaxed);
+
+    // once full, the oldest target is dropped so the map keeps showing the latest moves
+    if (length == max_path_points) {
+        std::move(path_points.begin() + 1, path_points.end(), path_points.begin());
+        length--;
+    }
+
+    path_points[length] = {x, y};
+    path_length.store(length + 1, std::memory_order_relaxed);
+
+    path_version.fetch_add(1, std::memory_order_release);
 }
 
-void Robot::turn(double x, double y, bool reverse) {
+dlib::MotionResult<Degrees> Robot::turn(double x, double y, bool reverse) {
     auto point = dlib::Vector2d(meters(x),meters(y));
     auto heading = odom.angle_to(point, reverse);
-    turn_absolute(heading.in(degrees));
+    return turn_absolute(heading.in(degrees));
 }
 
-void Robot::turn_with_precision(double x, double y, bool reverse){
+dlib::MotionResult<Degrees> Robot::turn_with_precision(double x, double y, bool reverse){
     auto point = dlib::Vector2d(meters(x),meters(y));
     auto heading = odom.angle_to(point,reverse);
-    turn_precise(heading.in(degrees));
+    return turn_precise(heading.in(degrees));
+}
+
+dlib::PidGains Robot::autotune_linear(dlib::RelayAutotunerConfig<Meters> config, dlib::ZieglerNicholsRule rule) {
+    // oscillate around the current position with a bang-bang relay to find the critical point
+    auto target_displacement = chassis.forward_motor_displacement();
+    dlib::RelayAutotuner<Meters> tuner(config);
+
+    while (!tuner.is_done()) {
+        auto error = dlib::linear_error(target_displacement, chassis.forward_motor_displacement());
+        auto voltage = tuner.update(error, milli(seconds)(20));
+        chassis.move_voltage(voltage);
+        pros::delay(20);
+    }
+    chassis.brake();
+
+    auto result = tuner.get_result();
+    dlib::log_info("ku: {} tu: {}s", result.ultimate_gain, result.ultimate_period.in(seconds));
+
+    return tuner.ziegler_nichols(rule);
+}
+
+dlib::PidGains Robot::autotune_angular(dlib::RelayAutotunerConfig<Degrees> config, dlib::ZieglerNicholsRule rule) {
+    imu.wait_until_calibrated();
+
+    auto target_heading = imu.get_rotation();
+    dlib::RelayAutotuner<Degrees> tuner(config);
+
+    while (!tuner.is_done()) {
+        auto error = dlib::angular_error(target_heading, imu.get_rotation());
+        auto voltage = tuner.update(error, milli(seconds)(20));
+        chassis.turn_voltage(-voltage);
+        pros::delay(20);
+    }
+    chassis.brake();
+
+    auto result = tuner.get_result();
+    dlib::log_info("ku: {} tu: {}s", result.ultimate_gain, result.ultimate_period.in(seconds));
+
+    return tuner.ziegler_nichols(rule);
+}
+
+// charged on top of the time taken to any candidate that didn't settle, longer than any settler timeout,
+// so a candidate that stalls short of the target early can never beat one that gets there (s)
+static constexpr double unsettled_penalty = 10;
+
+dlib::PidGains Robot::refine_linear_gains(dlib::GainSearchConfig config, double displacement, double overshoot_weight) {
+    dlib::GainSearch search(config);
+    auto previous_gains = linear_pid.get_gains();
+    
+    // alternate directions so the robot stays in roughly the same spot
+    double direction = 1;
+
+    while (!search.is_done()) {
+        linear_pid.set_gains(search.next_candidate());
+        auto result = move_pid(meters(displacement * direction));
+        double cost = result.elapsed_time.in(seconds) + overshoot_weight * result.overshoot.in(meters);
+        if (result.exit_state != dlib::SettleState::Settled) {
+            cost += unsettled_penalty + overshoot_weight * au::abs(result.final_error).in(meters);
+        }
+        search.report(cost);
+        direction = -direction;
+        pros::delay(250);
+    }
+
+    linear_pid.set_gains(previous_gains);
+
+    auto best = search.get_best_gains();
+    dlib::log_info("kp: {} ki: {} kd: {} cost: {}", best.kp, best.ki, best.kd, search.get_best_cost());
+
+    return best;
+}
+
+dlib::PidGains Robot::refine_angular_gains(dlib::GainSearchConfig config, double degrees, double overshoot_weight) {
+    dlib::GainSearch search(config);
+    auto previous_gains = angular_pid.get_gains();
+    double direction = 1;
+
+    while (!search.is_done()) {
+        angular_pid.set_gains(search.next_candidate());
+        auto result = turn_relative(au::degrees(degrees * direction));
+        double cost = result.elapsed_time.in(seconds) + overshoot_weight * result.overshoot.in(au::degrees);
+        if (result.exit_state != dlib::SettleState::Settled) {
+            cost += unsettled_penalty + overshoot_weight * au::abs(result.final_error).in(au::degrees);
+        }
+        search.report(cost);
+        direction = -direction;
+        pros::delay(250);
+    }
+
+    angular_pid.set_gains(previous_gains);
+
+    auto best = search.get_best_gains();
+    dlib::log_info("kp: {} ki: {} kd: {} cost: {}", best.kp, best.ki, best.kd, search.get_best_cost());
+
+    return best;
+}
+
+// the streamed channels, in the order start_streaming adds them
+enum StreamChannel : int8_t {
+    StreamX,
+    StreamY,
+    StreamTheta,
+    StreamLeftVelocity,
+    StreamRightVelocity,
+    StreamSetpointPosition,
+    StreamSetpointVelocity,
+    StreamLeftVoltage,
+    StreamRightVoltage,
+    StreamError
+};
+
+Quantity<Meters, double> MotionSample::forward_displacement() const {
+    return (left_displacement + right_displacement) / 2.0;
+}
+
+Quantity<MetersPerSecond, double> MotionSample::forward_velocity() const {
+    return (left_velocity + right_velocity) / 2.0;
+}
+
+MotionSample Robot::sample_motion() {
+    auto left_velocity = chassis.left_motors_velocity();
+    auto right_velocity = chassis.right_motors_velocity();
+
+    return {
+        odom.get_position(),
+        chassis.left_motors_displacement(),
+        chassis.right_motors_displacement(),
+        imu.get_rotation(),
+        left_velocity,
+        right_velocity,
+        chassis.kinematics.to_chassis_speeds({left_velocity, right_velocity}).angular
+    };
+}
+
+void Robot::log_tick(dlib::TelemetryController controller, const MotionSample& sample, double setpoint_position, double setpoint_velocity, double error, dlib::SettleState state) {
+    if (!logger.is_running() && !telemetry_stream.is_running() && !diagnostics_enabled) {
+        return;
+    }
+
+    dlib::TelemetryRecord record {
+        pros::millis(),
+        static_cast<uint16_t>(motion_summary.motions),
+        static_cast<uint8_t>(dlib::telemetry_motion(controller)),
+        static_cast<uint8_t>(state),
+        static_cast<float>(sample.pose.x.in(meters)),
+        static_cast<float>(sample.pose.y.in(meters)),
+        static_cast<float>(sample.pose.theta.in(radians)),
+        static_cast<float>(sample.left_displacement.in(meters)),
+        static_cast<float>(sample.right_displacement.in(meters)),
+        static_cast<float>(sample.rotation.in(degrees)),
+        static_cast<float>(sample.left_velocity.in(meters_per_second)),
+        static_cast<float>(sample.right_velocity.in(meters_per_second)),
+        static_cast<float>(setpoint_position),
+        static_cast<float>(setpoint_velocity),
+        static_cast<float>(chassis.left_motors.get_commanded_voltage().in(volts)),
+        static_cast<float>(chassis.right_motors.get_commanded_voltage().in(volts)),
+        static_cast<float>(error),
+        static_cast<uint8_t>(controller)
+    };
+
+    logger.log(record);
+
+    if (diagnostics_enabled) {
+        diagnostic_records.push(record);
+    }
+
+    telemetry_stream.set(StreamX, record.x);
+    telemetry_stream.set(StreamY, record.y);
+    telemetry_stream.set(StreamTheta, record.theta);
+    telemetry_stream.set(StreamLeftVelocity, record.left_velocity);
+    telemetry_stream.set(StreamRightVelocity, record.right_velocity);
+    telemetry_stream.set(StreamSetpointPosition, record.setpoint_position);
+    telemetry_stream.set(StreamSetpointVelocity, record.setpoint_velocity);
+    telemetry_stream.set(StreamLeftVoltage, record.left_voltage);
+    telemetry_stream.set(StreamRightVoltage, record.right_voltage);
+    telemetry_stream.set(StreamError, record.error);
+}
+
+bool Robot::start_logging() {
+    char path[32];
+
+    // never overwrite an old run
+    for (int run = 0; run < 1000; run++) {
+        std::snprintf(path, sizeof(path), "/usd/run_%d.dlog", run);
+
+        FILE* existing = std::fopen(path, "rb");
+        if (existing == nullptr) {
+            return logger.start(path);
+        }
+        std::fclose(existing);
+    }
+
+    return false;
+}
+
+void Robot::start_streaming() {
+    telemetry_stream.add_channel("x", "m", 0.001);
+    telemetry_stream.add_channel("y", "m", 0.001);
+    telemetry_stream.add_channel("theta", "rad", 0.001);
+    telemetry_stream.add_channel("left_velocity", "m/s", 0.001);
+    telemetry_stream.add_channel("right_velocity", "m/s", 0.001);
+    // meters for linear motions, degrees for turns
+    telemetry_stream.add_channel("setpoint_position", "m|deg", 0.001);
+    telemetry_stream.add_channel("setpoint_velocity", "m/s", 0.001);
+    telemetry_stream.add_channel("left_voltage", "V", 0.01);
+    telemetry_stream.add_channel("right_voltage", "V", 0.01);
+    telemetry_stream.add_channel("error", "m|deg", 0.001);
+
+    telemetry_stream.start();
 }
 
 void Robot::start_odom() {
@@ -170,5 +531,22 @@ void Robot::start_odom() {
     });
 }
 
+void Robot::start_intake() {
+    intake_updater = std::make_unique<pros::Task>([this]() {
+        while (true) {
+            intake.update();
 
+            pros::delay(10);
+        }
+    });
+}
 
+void Robot::start_color_sort(ColorSortConfig config) {
+    color_sort = std::make_unique<ColorSort>(intake, config);
+    color_sort->start();
+}
+
+void Robot::start_power_management(PowerManagerConfig config) {
+    power_manager = std::make_unique<PowerManager>(chassis, intake, config);
+    power_manager->start();
+}
@@ -0,0 +1,97 @@
+#include "subsystems/auton_selector.hpp"
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+static Auton autons[max_autons];
+static size_t auton_count = 0;
+
+static std::atomic<int32_t> selected_index{-1};
+static void (*selected_callback)(const Auton&) = nullptr;
+
+// prepare is run by the background task, or by run_selected_auton if the task hasn't finished
+static pros::Mutex prepare_mutex;
+static int32_t prepared_index = -1;
+static std::unique_ptr<pros::Task> prepare_task = nullptr;
+
+static void prepare_selected(){
+	std::lock_guard<pros::Mutex> guard(prepare_mutex);
+
+	int32_t index = selected_index;
+	if(index < 0 || index == prepared_index){
+		return;
+	}
+
+	if(autons[index].prepare != nullptr){
+		autons[index].prepare();
+	}
+	prepared_index = index;
+}
+
+bool register_auton(Auton auton){
+	if(auton_count == max_autons || auton.routine == nullptr){
+		return false;
+	}
+
+	autons[auton_count] = auton;
+	auton_count++;
+	return true;
+}
+
+size_t get_auton_count(){
+	return auton_count;
+}
+
+const Auton& get_auton(size_t index){
+	return autons[index];
+}
+
+bool select_auton(size_t index){
+	if(index >= auton_count){
+		return false;
+	}
+
+	selected_index = index;
+
+	if(selected_callback != nullptr){
+		selected_callback(autons[index]);
+	}
+
+	// selections come from the gui, so the preparing is handed off to keep the screen responsive
+	if(prepare_task == nullptr){
+		prepare_task = std::make_unique<pros::Task>([](){
+			while(true){
+				pros::Task::notify_take(true, TIMEOUT_MAX);
+				prepare_selected();
+			}
+		}, TASK_PRIORITY_MIN + 1, TASK_STACK_DEPTH_DEFAULT, "auton prepare");
+	}
+	prepare_task->notify();
+
+	return true;
+}
+
+const Auton* get_selected_auton(){
+	int32_t index = selected_index;
+	return index < 0 ? nullptr : &autons[index];
+}
+
+void on_auton_selected(void (*callback)(const Auton&)){
+	selected_callback = callback;
+}
+
+Alliance get_auton_alliance(const Auton& auton){
+	return auton.category == AutonCategory::Blue ? Alliance::Blue : Alliance::Red;
+}
+
+bool run_selected_auton(){
+	const Auton* auton = get_selected_auton();
+	if(auton == nullptr){
+		return false;
+	}
+
+	// waits for the background task if it is partway through, so the routine never starts half prepared
+	prepare_selected();
+	auton->routine();
+	return true;
+}
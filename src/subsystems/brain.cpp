@@ -1,7 +1,9 @@
 #include "subsystems/brain.hpp"
 #include "pros/misc.hpp"
+#include <climits>
+#include <cmath>
+#include <memory>
 
-#include <iostream>
 
 static lv_style_t button_pressed;
 static lv_style_t blue_button_released;
@@ -35,153 +37,139 @@ static lv_obj_t * menu;
 static lv_obj_t * coords_x;
 static lv_obj_t * coords_y;
 
-// static buttons
-static lv_obj_t * blue_left_elim;
-static lv_obj_t * blue_right_elim;
-static lv_obj_t * blue_solo_wp;
-
-static lv_obj_t * red_ring_elim;
-static lv_obj_t * red_goal_elim;
-static lv_obj_t * red_solo_wp;
-
-static lv_obj_t * risky_skills;
-static lv_obj_t * safe_skills;
+// one button per registered auton, in registry order
+static lv_obj_t * auton_buttons[max_autons];
+static lv_obj_t * selected_button = nullptr;
 
 // static pages
 
 static lv_obj_t * blue_selector_page;
 static lv_obj_t * red_selector_page;
 static lv_obj_t * skills_selector_page;
+static lv_obj_t * field_map_page;
+static lv_obj_t * diagnostic_page;
 
-static int selected;
+// the last values drawn, widgets are only touched when these change
+static DashboardConfig dashboard_config;
+// coordinates are kept as a count of coordinate_resolution steps, the same rounding the label shows
+static long displayed_x = LONG_MIN;
+static long displayed_y = LONG_MIN;
+static int32_t displayed_capacity = -1;
+static int8_t displayed_battery_level = -1;
+
+static std::unique_ptr<pros::Task> dashboard_task = nullptr;
 
 static void slider_event_cb(lv_event_t * e){
     lv_obj_t * slider = lv_event_get_target(e);
 
     /*Refresh the text*/
-	std::cout << lv_slider_get_value(slider) << std::endl;
     lv_label_set_text_fmt(label, "Freak Meter: %d%%", lv_slider_get_value(slider));
     lv_obj_align_to(label, slider, LV_ALIGN_OUT_TOP_MID, 0, 0);
 
 }
 
 void update_battery_percent() {
-	auto capacity = pros::battery::get_capacity();
+	int32_t capacity = std::lround(pros::battery::get_capacity());
 
-	lv_label_set_text_fmt(battery_label, "Battery Percent: %d%%", (int)pros::battery::get_capacity());
-	lv_obj_align_to(battery_label,lv_layer_top(), LV_ALIGN_TOP_RIGHT,-5,5);
+	if(capacity != displayed_capacity){
+		displayed_capacity = capacity;
 
-	if(capacity > 25){
-		lv_img_set_src(image, LV_SYMBOL_BATTERY_2);
-		if(capacity > 50){
+		// the label's width changes with the text, so it is realigned with it
+		lv_label_set_text_fmt(battery_label, "Battery Percent: %d%%", (int)capacity);
+		lv_obj_align_to(battery_label,lv_layer_top(), LV_ALIGN_TOP_RIGHT,-5,5);
+	}
+
+	// 0: warning, 1: 2 bars, 2: 3 bars, 3: full
+	int8_t level = capacity > 75 ? 3 : capacity > 50 ? 2 : capacity > 25 ? 1 : 0;
+
+	if(level == displayed_battery_level){
+		return;
+	}
+	displayed_battery_level = level;
+
+	switch(level){
+		case 3:
+			lv_img_set_src(image, LV_SYMBOL_BATTERY_FULL);
+			lv_style_set_text_color(&dynamic_battery, lv_color_make(191,255,163));
+			break;
+		case 2:
 			lv_img_set_src(image, LV_SYMBOL_BATTERY_3);
-			if(capacity > 75){
-				lv_img_set_src(image, LV_SYMBOL_BATTERY_FULL);
-				lv_style_set_text_color(&dynamic_battery, lv_color_make(191,255,163));
-			}
-			else{
-				lv_img_set_src(image, LV_SYMBOL_BATTERY_3);
-				lv_style_set_text_color(&dynamic_battery, lv_color_make(221,255,153));
-			}
-		}
-		else{
+			lv_style_set_text_color(&dynamic_battery, lv_color_make(221,255,153));
+			break;
+		case 1:
 			lv_img_set_src(image, LV_SYMBOL_BATTERY_2);
 			lv_style_set_text_color(&dynamic_battery, lv_color_make(255,228,156));
-		}
-	}
-	else{
-		lv_img_set_src(image, LV_SYMBOL_WARNING);
-		lv_style_set_text_color(&dynamic_battery, lv_color_make(255,133,133));
+			break;
+		default:
+			lv_img_set_src(image, LV_SYMBOL_WARNING);
+			lv_style_set_text_color(&dynamic_battery, lv_color_make(255,133,133));
 	}
-	
-	lv_obj_align_to(image,lv_layer_top(),LV_ALIGN_TOP_RIGHT,-160,5);
 
+	// the color is shared by every widget with the style
+	lv_obj_report_style_change(&dynamic_battery);
+	lv_obj_align_to(image,lv_layer_top(),LV_ALIGN_TOP_RIGHT,-160,5);
 }
 
-static void remove_button_style(){
-	lv_obj_remove_style(red_solo_wp,&button_selected,0);
-	lv_obj_remove_style(red_ring_elim,&button_selected,0);
-	lv_obj_remove_style(red_goal_elim,&button_selected,0);
-	lv_obj_remove_style(blue_left_elim,&button_selected,0);
-	lv_obj_remove_style(blue_right_elim,&button_selected,0);
-	lv_obj_remove_style(blue_solo_wp,&button_selected,0);
-	lv_obj_remove_style(risky_skills,&button_selected,0);
-	lv_obj_remove_style(safe_skills,&button_selected,0);
+static void auton_button_event(lv_event_t * e){
+	size_t index = (size_t)(uintptr_t)lv_event_get_user_data(e);
+	if(!select_auton(index)){
+		return;
+	}
+
+	if(selected_button != nullptr){
+		lv_obj_remove_style(selected_button,&button_selected,0);
+	}
+	selected_button = auton_buttons[index];
+	lv_obj_add_style(selected_button,&button_selected,0);
+
+	// every page shows the selection, so it can be checked from any of them
+	static char selected_text[64];
+	snprintf(selected_text, sizeof(selected_text), "Selected Auton: %s", get_auton(index).name);
+
+	lv_label_set_text_static(red_selected_label, selected_text);
+	lv_label_set_text_static(blue_selected_label, selected_text);
+	lv_label_set_text_static(skills_selected_label, selected_text);
+	lv_obj_align_to(red_selected_label,red_selector_page,LV_ALIGN_BOTTOM_MID,0,0);
+	lv_obj_align_to(blue_selected_label,blue_selector_page,LV_ALIGN_BOTTOM_MID,0,0);
+	lv_obj_align_to(skills_selected_label,skills_selector_page,LV_ALIGN_BOTTOM_MID,0,0);
 }
 
-static void selector_button_manager(lv_event_t * e){
-	lv_event_code_t code = e->code;
-    lv_obj_t * btn = lv_event_get_target(e); // Get the button object
-    if (code == LV_EVENT_PRESSED) {
-		if(btn == red_ring_elim){
-			selected = 1;
-			lv_label_set_text(red_selected_label, "Selected Auton: Red 7 Ring Elim");
-			lv_label_set_text(blue_selected_label, "Selected Auton: Red 7 Ring Elim");
-			lv_obj_align_to(red_selected_label,red_selector_page,LV_ALIGN_BOTTOM_MID,0,0);
-			remove_button_style();
-			lv_obj_add_style(red_ring_elim,&button_selected,0);
-		}
-		else if(btn == red_solo_wp){
-			selected = 2;
-			lv_label_set_text(red_selected_label, "Selected Auton: Red Solo WP");
-			lv_label_set_text(blue_selected_label, "Selected Auton: Red Solo WP");
-			lv_obj_align_to(red_selected_label,red_selector_page,LV_ALIGN_BOTTOM_MID,0,0);
-			remove_button_style();
-			lv_obj_add_style(red_solo_wp,&button_selected,0);
-		}
-		else if(btn == red_goal_elim){
-			selected = 3;
-			lv_label_set_text(red_selected_label, "Selected Auton: Red Goal Elim");
-			lv_label_set_text(blue_selected_label, "Selected Auton: Red Goal Elim");
-			lv_obj_align_to(red_selected_label,red_selector_page,LV_ALIGN_BOTTOM_MID,0,0);
-			remove_button_style();
-			lv_obj_add_style(red_goal_elim,&button_selected,0);
-		}
-		else if(btn == blue_left_elim){
-			selected = 4;
-			lv_label_set_text(blue_selected_label, "Selected Auton: Blue Ring Elim");
-			lv_label_set_text(red_selected_label, "Selected Auton: Blue Ring Elim");
-			lv_obj_align_to(blue_selected_label,blue_selector_page,LV_ALIGN_BOTTOM_MID,0,0);
-			remove_button_style();
-			lv_obj_add_style(blue_left_elim,&button_selected,0);
-		}
-		else if(btn == blue_solo_wp){
-			selected = 5;
-			lv_label_set_text(blue_selected_label, "Selected Auton: Blue Solo WP");
-			lv_label_set_text(red_selected_label, "Selected Auton: Blue Solo WP");
-			lv_obj_align_to(blue_selected_label,blue_selector_page,LV_ALIGN_BOTTOM_MID,0,0);
-			remove_button_style();
-			lv_obj_add_style(blue_solo_wp,&button_selected,0);
-		}
-		else if(btn == blue_right_elim){
-			selected = 6;
-			lv_label_set_text(blue_selected_label, "Selected Auton: Blue Goal Elim");
-			lv_label_set_text(red_selected_label, "Selected Auton: Blue Goal Elim");
-			lv_obj_align_to(blue_selected_label,blue_selector_page,LV_ALIGN_BOTTOM_MID,0,0);
-			remove_button_style();
-			lv_obj_add_style(blue_right_elim,&button_selected,0);
-		}
-		else if(btn == risky_skills){
-			selected = 7;
-			lv_label_set_text(skills_selected_label, "Selected Auton: Risky Skills");
-			lv_label_set_text(red_selected_label, "Selected Auton: Risky Skills");
-			lv_label_set_text(blue_selected_label, "Selected Auton: Risky Skills");
-			lv_obj_align_to(skills_selected_label,skills_selector_page,LV_ALIGN_BOTTOM_MID,0,0);
-			remove_button_style();
-			lv_obj_add_style(risky_skills,&button_selected,0);
-		}
-		else if(btn == safe_skills){
-			selected = 8;
-			lv_label_set_text(skills_selected_label, "Selected Auton: Safe Skills");
-			lv_label_set_text(red_selected_label, "Selected Auton: Safe Skills");
-			lv_label_set_text(blue_selected_label, "Selected Auton: Safe Skills");
-			lv_obj_align_to(skills_selected_label,skills_selector_page,LV_ALIGN_BOTTOM_MID,0,0);
-			remove_button_style();
-			lv_obj_add_style(safe_skills,&button_selected,0);
+// a page with a button for every registered auton in the category
+static lv_obj_t * create_selector_page(AutonCategory category, lv_style_t * released_style, lv_obj_t ** selected_label){
+	lv_obj_t * page = lv_menu_page_create(menu, NULL);
+
+	cont = lv_menu_cont_create(page);
+
+	for(size_t i = 0; i < get_auton_count(); i++){
+		const Auton& auton = get_auton(i);
+		if(auton.category != category){
+			continue;
 		}
+
+		lv_obj_t * button = lv_btn_create(cont);
+
+		lv_obj_add_style(button,&button_pressed,LV_STATE_PRESSED);
+		lv_obj_add_style(button,released_style,0);
+		lv_obj_set_size(button, 140, 50);
+		lv_obj_align(button, LV_ALIGN_CENTER, 10, 10);
+
+		label = lv_label_create(button);
+		lv_label_set_text_static(label, auton.name);
+		lv_obj_center(label);
+
+		// the registry index is all the event needs to know which auton was pressed
+		lv_obj_add_event_cb(button, auton_button_event, LV_EVENT_PRESSED, (void *)(uintptr_t)i);
+		auton_buttons[i] = button;
 	}
+
+	*selected_label = lv_label_create(page);
+	lv_label_set_text(*selected_label, "Selected Auton: NONE");
+	lv_obj_align_to(*selected_label,page,LV_ALIGN_BOTTOM_MID,0,0);
+
+	return page;
 }
 
+
 void initialize_brain(){
 	lv_style_init(&button_pressed);
 	lv_style_set_bg_color(&button_pressed,lv_palette_main(LV_PALETTE_ORANGE));
@@ -223,148 +211,16 @@ void initialize_brain(){
 	lv_obj_add_style(menu,&background_color,0);
     lv_obj_center(menu);
 
-	// sub-pages
-	red_selector_page = lv_menu_page_create(menu, NULL);
-
-	// red container
-	cont = lv_menu_cont_create(red_selector_page);
-
-	// subpage buttons
-	red_ring_elim = lv_btn_create(cont);
+	// selector pages, generated from the auton registry
+	red_selector_page = create_selector_page(AutonCategory::Red, &red_button_released, &red_selected_label);
+	blue_selector_page = create_selector_page(AutonCategory::Blue, &blue_button_released, &blue_selected_label);
+	skills_selector_page = create_selector_page(AutonCategory::Skills, &skills_button_released, &skills_selected_label);
 
-	lv_obj_add_style(red_ring_elim,&button_pressed,LV_STATE_PRESSED);
-	lv_obj_add_style(red_ring_elim,&red_button_released,0);
-	lv_obj_set_size(red_ring_elim, 140, 50);
-	lv_obj_align(red_ring_elim, LV_ALIGN_CENTER, 10, 10);
-
-	label = lv_label_create(red_ring_elim);     
-    lv_label_set_text(label, "Red Ring Elim");              
-    lv_obj_center(label);
-
-	lv_obj_add_event_cb(red_ring_elim,selector_button_manager, LV_EVENT_PRESSED,NULL);
-
-	red_solo_wp = lv_btn_create(cont);
-
-	lv_obj_add_style(red_solo_wp,&button_pressed,LV_STATE_PRESSED);
-	lv_obj_add_style(red_solo_wp,&red_button_released,0);
-	lv_obj_set_size(red_solo_wp, 140, 50);
-	lv_obj_align(red_solo_wp, LV_ALIGN_CENTER, 10, 10);
-
-	label = lv_label_create(red_solo_wp);      
-    lv_label_set_text(label, "Red Solo WP");          
-    lv_obj_center(label);
-
-	lv_obj_add_event_cb(red_solo_wp,selector_button_manager, LV_EVENT_PRESSED,NULL);
-
-	red_goal_elim = lv_btn_create(cont);
-
-	lv_obj_add_style(red_goal_elim,&button_pressed,LV_STATE_PRESSED);
-	lv_obj_add_style(red_goal_elim,&red_button_released,0);
-	lv_obj_set_size(red_goal_elim, 140, 50);
-	lv_obj_align(red_goal_elim, LV_ALIGN_CENTER, 10, 10);
-
-	label = lv_label_create(red_goal_elim);  
-    lv_label_set_text(label, "Red Goal Elim");  
-    lv_obj_center(label);
-
-	lv_obj_add_event_cb(red_goal_elim,selector_button_manager, LV_EVENT_PRESSED,NULL);
-
-	// selected label
-
-	red_selected_label = lv_label_create(red_selector_page);
-	lv_label_set_text(red_selected_label, "Selected Auton: NONE");
-	lv_obj_align_to(red_selected_label,red_selector_page,LV_ALIGN_BOTTOM_MID,0,0);
+	// like the field map, the charts are created by start_dashboard
+	diagnostic_page = lv_menu_page_create(menu, NULL);
 
-	// blue
-	blue_selector_page = lv_menu_page_create(menu, NULL);
-
-	// blue container
-	cont = lv_menu_cont_create(blue_selector_page);
-
-	// subpage buttons
-	blue_left_elim = lv_btn_create(cont);
-
-	lv_obj_add_style(blue_left_elim,&button_pressed,LV_STATE_PRESSED);
-	lv_obj_add_style(blue_left_elim,&blue_button_released,0);
-	lv_obj_set_size(blue_left_elim, 140, 50);
-	lv_obj_align(blue_left_elim, LV_ALIGN_CENTER, 10, 10);
-
-	label = lv_label_create(blue_left_elim);     
-    lv_label_set_text(label, "Blue Left Elim");              
-    lv_obj_center(label);
-
-	lv_obj_add_event_cb(blue_left_elim,selector_button_manager, LV_EVENT_PRESSED,NULL);
-
-	blue_solo_wp = lv_btn_create(cont);
-
-	lv_obj_add_style(blue_solo_wp,&button_pressed,LV_STATE_PRESSED);
-	lv_obj_add_style(blue_solo_wp,&blue_button_released,0);
-	lv_obj_set_size(blue_solo_wp, 140, 50);
-	lv_obj_align(blue_solo_wp, LV_ALIGN_CENTER, 10, 10);
-
-	label = lv_label_create(blue_solo_wp);      
-    lv_label_set_text(label, "Blue Solo WP");          
-    lv_obj_center(label);
-
-	lv_obj_add_event_cb(blue_solo_wp,selector_button_manager, LV_EVENT_PRESSED,NULL);
-
-	blue_right_elim = lv_btn_create(cont);
-
-	lv_obj_add_style(blue_right_elim,&button_pressed,LV_STATE_PRESSED);
-	lv_obj_add_style(blue_right_elim,&blue_button_released,0);
-	lv_obj_set_size(blue_right_elim, 140, 50);
-	lv_obj_align(blue_right_elim, LV_ALIGN_CENTER, 10, 10);
-
-	label = lv_label_create(blue_right_elim);  
-    lv_label_set_text(label, "Blue Right Elim");  
-    lv_obj_center(label);
-
-	lv_obj_add_event_cb(blue_right_elim,selector_button_manager, LV_EVENT_PRESSED,NULL);
-
-	// selected label
-
-	blue_selected_label = lv_label_create(blue_selector_page);
-	lv_label_set_text(blue_selected_label, "Selected Auton: NONE");
-	lv_obj_align_to(blue_selected_label,blue_selector_page,LV_ALIGN_BOTTOM_MID,0,0);
-
-	skills_selector_page = lv_menu_page_create(menu, NULL);
-
-	// skills container
-	cont = lv_menu_cont_create(skills_selector_page);
-
-	// subpage buttons
-	risky_skills = lv_btn_create(cont);
-
-	lv_obj_add_style(risky_skills,&button_pressed,LV_STATE_PRESSED);
-	lv_obj_add_style(risky_skills,&skills_button_released,0);
-	lv_obj_set_size(risky_skills, 140, 50);
-	lv_obj_align(risky_skills, LV_ALIGN_CENTER, 10, 10);
-
-	label = lv_label_create(risky_skills);     
-    lv_label_set_text(label, "Risky Skills");              
-    lv_obj_center(label);
-
-	lv_obj_add_event_cb(risky_skills,selector_button_manager, LV_EVENT_PRESSED,NULL);
-
-	safe_skills = lv_btn_create(cont);
-
-	lv_obj_add_style(safe_skills,&button_pressed,LV_STATE_PRESSED);
-	lv_obj_add_style(safe_skills,&skills_button_released,0);
-	lv_obj_set_size(safe_skills, 140, 50);
-	lv_obj_align(safe_skills, LV_ALIGN_CENTER, 10, 10);
-
-	label = lv_label_create(safe_skills);      
-    lv_label_set_text(label, "Safe Skills");          
-    lv_obj_center(label);
-
-	lv_obj_add_event_cb(safe_skills,selector_button_manager, LV_EVENT_PRESSED,NULL);
-
-	skills_selected_label = lv_label_create(skills_selector_page);
-	lv_label_set_text(skills_selected_label, "Selected Auton: NONE");
-	lv_obj_align_to(skills_selected_label,skills_selector_page,LV_ALIGN_BOTTOM_MID,0,0);
-
-
-	lv_obj_t * diagnostic_page = lv_menu_page_create(menu, NULL);
+	// the map itself is drawn once the dashboard starts and has a robot to follow
+	field_map_page = lv_menu_page_create(menu, NULL);
 
 	lv_obj_t * freak_meter_page = lv_menu_page_create(menu, NULL);
 
@@ -398,6 +254,16 @@ void initialize_brain(){
 	lv_label_set_text(menu_label, "Skills");
 	lv_menu_set_load_page_event(menu, cont, skills_selector_page);
 
+	cont = lv_menu_cont_create(main_menu);
+	menu_label = lv_label_create(cont);
+	lv_label_set_text(menu_label, "Field Map");
+	lv_menu_set_load_page_event(menu, cont, field_map_page);
+
+	cont = lv_menu_cont_create(main_menu);
+	menu_label = lv_label_create(cont);
+	lv_label_set_text(menu_label, "Diagnostics");
+	lv_menu_set_load_page_event(menu, cont, diagnostic_page);
+
 	cont = lv_menu_cont_create(main_menu);
 	menu_label = lv_label_create(cont);
 	lv_label_set_text(menu_label, "Freak Meter");
@@ -416,13 +282,52 @@ void initialize_brain(){
 	
 }
 
-int get_selected(){
-	return selected;
-}
-
 void print_coords(Robot& robot){
 	dlib::Pose2d pose = robot.odom.get_position();
+	double x = pose.x.in(meters);
+	double y = pose.y.in(meters);
+
+	// the labels point at these buffers, so updating them doesn't allocate
+	static char x_text[16];
+	static char y_text[16];
 
-	lv_label_set_text(coords_x, std::format("X: {:.2f}", pose.x.in(meters)).c_str());
-	lv_label_set_text(coords_y, std::format("Y: {:.2f}", pose.y.in(meters)).c_str());
+	// only redraw when the rounded value changes, comparing raw values would miss slow drifts across a step
+	long rounded_x = std::lround(x / dashboard_config.coordinate_resolution);
+	long rounded_y = std::lround(y / dashboard_config.coordinate_resolution);
+
+	if(rounded_x != displayed_x){
+		displayed_x = rounded_x;
+		snprintf(x_text, sizeof(x_text), "X: %.2f", rounded_x * dashboard_config.coordinate_resolution);
+		lv_label_set_text_static(coords_x, x_text);
+	}
+
+	if(rounded_y != displayed_y){
+		displayed_y = rounded_y;
+		snprintf(y_text, sizeof(y_text), "Y: %.2f", rounded_y * dashboard_config.coordinate_resolution);
+		lv_label_set_text_static(coords_y, y_text);
+	}
+}
+
+void start_dashboard(Robot& robot, DashboardConfig config){
+	dashboard_config = config;
+
+	if(dashboard_task != nullptr){
+		return;
+	}
+
+	create_field_map(lv_menu_cont_create(field_map_page), config.field_map);
+	create_diagnostics(lv_menu_cont_create(diagnostic_page), config.diagnostics);
+	robot.diagnostics_enabled = true;
+
+	dashboard_task = std::make_unique<pros::Task>([&robot](){
+		uint32_t time = pros::millis();
+
+		while(true){
+			print_coords(robot);
+			update_battery_percent();
+			update_field_map(robot);
+			update_diagnostics(robot);
+			pros::Task::delay_until(&time, dashboard_config.period);
+		}
+	}, TASK_PRIORITY_MIN + 1, TASK_STACK_DEPTH_DEFAULT, "dashboard");
 }
\ No newline at end of file
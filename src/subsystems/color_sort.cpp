@@ -0,0 +1,119 @@
+#include "subsystems/color_sort.hpp"
+#include <algorithm>
+#include <cmath>
+
+bool HueRange::contains(double hue) const {
+    if(min <= max){
+        return hue >= min && hue <= max;
+    }
+
+    // the range wraps around 360
+    return hue >= min || hue <= max;
+}
+
+ColorSort::ColorSort(
+    Intake& intake,
+    ColorSortConfig config
+) : intake(intake), config(config), optical(config.optical_port)
+{
+    // read as fast as the sensor allows, with the led on so ambient light doesn't change the hue
+    optical.set_integration_time(3);
+    optical.set_led_pwm(100);
+};
+
+std::optional<Alliance> ColorSort::classify(double hue){
+    if(hue == PROS_ERR_F){
+        return std::nullopt;
+    }
+
+    if(config.red_hue.contains(hue)){
+        return Alliance::Red;
+    }
+    if(config.blue_hue.contains(hue)){
+        return Alliance::Blue;
+    }
+
+    return std::nullopt;
+}
+
+au::Quantity<au::MetersPerSecond, double> ColorSort::surface_speed(void){
+    pros::Motor* motors[3] = {&intake.intake_motor, &intake.intake_motor_2, &intake.middle_motor};
+
+    auto velocity = motors[config.eject_motor]->get_actual_velocity();
+    if(velocity == PROS_ERR_F){
+        return au::ZERO;
+    }
+
+    auto circumference = config.roller_diameter.in(au::meters) * M_PI;
+
+    // only forward motion carries the object toward the eject point
+    auto rpm = au::rpm(std::max(velocity, 0.0));
+
+    return au::meters_per_second(rpm.in(au::rps) * circumference);
+}
+
+void ColorSort::update(void){
+    uint32_t now = pros::millis();
+    auto period = au::milli(au::seconds)(static_cast<double>(now - last_update));
+    last_update = now;
+
+    // track how far each object has moved using the measured intake speed, so the timing holds when the intake slows down
+    if(pending_count > 0){
+        auto travelled = surface_speed() * period;
+
+        for(size_t i = 0; i < pending_count; i++){
+            pending[(pending_head + i) % max_pending] -= travelled;
+        }
+    }
+
+    if(ejecting && now - eject_start >= config.eject_time){
+        ejecting = false;
+        intake.stop_eject();
+    }
+
+    // the next object may already be at the eject point when the last eject ends
+    if(!ejecting && pending_count > 0 && pending[pending_head] <= au::ZERO){
+        pending_head = (pending_head + 1) % max_pending;
+        pending_count--;
+
+        ejecting = true;
+        eject_start = now;
+        ejected++;
+        intake.start_eject(config.eject_motor, config.eject_voltage);
+    }
+
+    // keep reading while objects are in flight, the next one can reach the sensor before the last is ejected
+    auto proximity = optical.get_proximity();
+    if(proximity == PROS_ERR || proximity < config.min_proximity){
+        object_present = false;
+        return;
+    }
+
+    // only classify each object once, as soon as its color is readable
+    if(object_present){
+        return;
+    }
+
+    auto color = classify(optical.get_hue());
+    if(!color.has_value()){
+        return;
+    }
+    object_present = true;
+
+    // with the queue full the object is let through, more than max_pending in flight means the distance is misconfigured
+    if(intake.do_sort && color.value() != intake.alliance && pending_count < max_pending){
+        pending[(pending_head + pending_count) % max_pending] = config.eject_distance;
+        pending_count++;
+    }
+}
+
+void ColorSort::start(void){
+    last_update = pros::millis();
+
+    task = std::make_unique<pros::Task>([this](){
+        while(true){
+            update();
+            pros::delay(config.update_period);
+        }
+    }, TASK_PRIORITY_MAX - 2, TASK_STACK_DEPTH_DEFAULT, "color sort");
+}
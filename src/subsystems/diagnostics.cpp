@@ -0,0 +1,203 @@
+#include "subsystems/diagnostics.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+// samples are stored as hundredths so lv_chart's integer points keep 2 decimal places
+static constexpr double chart_scale = 100;
+static constexpr size_t max_chart_series = 2;
+
+struct DiagnosticChart {
+	lv_obj_t * chart;
+	lv_obj_t * value_label;
+	const char * title;
+	char value_text[32];
+	lv_chart_series_t * series[max_chart_series];
+	size_t series_count;
+
+	// a circular buffer of samples, next is where the newest sample goes
+	float samples[max_chart_series][diagnostic_chart_points];
+	size_t next;
+	size_t count;
+	bool changed;
+
+	// what lv_chart draws, rewritten oldest to newest on each redraw
+	lv_coord_t points[max_chart_series][diagnostic_chart_points];
+};
+
+enum DiagnosticChartIndex {
+	ErrorChart,
+	VoltageChart,
+	VelocityChart,
+	TemperatureChart,
+	DiagnosticChartCount
+};
+
+static DiagnosticsConfig diagnostics_config;
+static DiagnosticChart charts[DiagnosticChartCount];
+static bool diagnostics_created = false;
+
+static uint32_t decimation_ticks = 0;
+static uint32_t last_redraw = 0;
+static uint32_t last_temperature = 0;
+
+static dlib::MotorGroupSample left_sample;
+static dlib::MotorGroupSample right_sample;
+
+static void create_chart(lv_obj_t * parent, DiagnosticChart& chart, const char * title, lv_color_t first, lv_color_t second, size_t series_count){
+	lv_obj_t * cont = lv_obj_create(parent);
+	lv_obj_set_size(cont, 215, 120);
+	lv_obj_set_flex_flow(cont, LV_FLEX_FLOW_COLUMN);
+	lv_obj_set_style_pad_all(cont, 4, 0);
+	lv_obj_clear_flag(cont, LV_OBJ_FLAG_SCROLLABLE);
+
+	chart.title = title;
+	chart.value_label = lv_label_create(cont);
+	lv_label_set_text(chart.value_label, title);
+
+	chart.chart = lv_chart_create(cont);
+	lv_obj_set_size(chart.chart, 200, 80);
+	lv_chart_set_type(chart.chart, LV_CHART_TYPE_LINE);
+	lv_chart_set_div_line_count(chart.chart, 3, 0);
+	lv_chart_set_point_count(chart.chart, diagnostic_chart_points);
+
+	// lines only, the point markers would cover each other at this density
+	lv_obj_set_style_size(chart.chart, 0, LV_PART_INDICATOR);
+
+	lv_color_t colors[max_chart_series] = {first, second};
+	chart.series_count = series_count;
+
+	for(size_t i = 0; i < series_count; i++){
+		std::fill(chart.points[i], chart.points[i] + diagnostic_chart_points, LV_CHART_POINT_NONE);
+
+		chart.series[i] = lv_chart_add_series(chart.chart, colors[i], LV_CHART_AXIS_PRIMARY_Y);
+		lv_chart_set_ext_y_array(chart.chart, chart.series[i], chart.points[i]);
+	}
+}
+
+static void push_sample(DiagnosticChart& chart, double first, double second = 0){
+	chart.samples[0][chart.next] = first;
+	chart.samples[1][chart.next] = second;
+
+	chart.next = (chart.next + 1) % diagnostic_chart_points;
+	chart.count = std::min(chart.count + 1, diagnostic_chart_points);
+	chart.changed = true;
+}
+
+static void redraw_chart(DiagnosticChart& chart){
+	if(!chart.changed || chart.count == 0){
+		return;
+	}
+	chart.changed = false;
+
+	size_t oldest = (chart.next + diagnostic_chart_points - chart.count) % diagnostic_chart_points;
+
+	// fit the range to the samples, with at least a unit of span so noise around 0 doesn't fill the chart
+	double min = INFINITY;
+	double max = -INFINITY;
+
+	for(size_t s = 0; s < chart.series_count; s++){
+		for(size_t i = 0; i < chart.count; i++){
+			double sample = chart.samples[s][(oldest + i) % diagnostic_chart_points];
+			min = std::min(min, sample);
+			max = std::max(max, sample);
+		}
+	}
+
+	// the range is also kept within what lv_coord_t can hold once scaled
+	min = std::clamp(std::floor(min), -320.0, 319.0);
+	max = std::clamp(std::max(std::ceil(max), min + 1), -319.0, 320.0);
+
+	// the newest sample is always drawn at the right edge
+	size_t empty = diagnostic_chart_points - chart.count;
+
+	for(size_t s = 0; s < chart.series_count; s++){
+		std::fill(chart.points[s], chart.points[s] + empty, LV_CHART_POINT_NONE);
+
+		for(size_t i = 0; i < chart.count; i++){
+			double sample = chart.samples[s][(oldest + i) % diagnostic_chart_points];
+			chart.points[s][empty + i] = (lv_coord_t)std::clamp(std::lround(sample * chart_scale), -32000L, 32000L);
+		}
+	}
+
+	lv_chart_set_range(chart.chart, LV_CHART_AXIS_PRIMARY_Y, (lv_coord_t)(min * chart_scale), (lv_coord_t)(max * chart_scale));
+	lv_chart_refresh(chart.chart);
+
+	// the newest value of the first series
+	double latest = chart.samples[0][(chart.next + diagnostic_chart_points - 1) % diagnostic_chart_points];
+	snprintf(chart.value_text, sizeof(chart.value_text), "%s: %.2f", chart.title, latest);
+	lv_label_set_text_static(chart.value_label, chart.value_text);
+}
+
+void create_diagnostics(lv_obj_t * parent, DiagnosticsConfig config){
+	if(diagnostics_created){
+		return;
+	}
+	diagnostics_created = true;
+
+	config.decimation = std::max<uint32_t>(config.decimation, 1);
+	diagnostics_config = config;
+
+	lv_obj_set_flex_flow(parent, LV_FLEX_FLOW_ROW_WRAP);
+
+	create_chart(parent, charts[ErrorChart], "Error", lv_palette_main(LV_PALETTE_RED), lv_color_black(), 1);
+	create_chart(parent, charts[VoltageChart], "Voltage L/R", lv_palette_main(LV_PALETTE_ORANGE), lv_palette_main(LV_PALETTE_PURPLE), 2);
+	create_chart(parent, charts[VelocityChart], "Velocity Set/Act", lv_palette_main(LV_PALETTE_BLUE), lv_palette_main(LV_PALETTE_GREEN), 2);
+	create_chart(parent, charts[TemperatureChart], "Temp Drive/Intake", lv_palette_main(LV_PALETTE_DEEP_ORANGE), lv_palette_main(LV_PALETTE_CYAN), 2);
+}
+
+void update_diagnostics(Robot& robot){
+	if(!diagnostics_created){
+		return;
+	}
+
+	// the motion loops push a record every tick, only every decimation'th one is charted
+	dlib::TelemetryRecord records[16];
+	size_t count;
+
+	while((count = robot.diagnostic_records.pop(records, 16)) > 0){
+		for(size_t i = 0; i < count; i++){
+			decimation_ticks++;
+			if(decimation_ticks < diagnostics_config.decimation){
+				continue;
+			}
+			decimation_ticks = 0;
+
+			const dlib::TelemetryRecord& record = records[i];
+			push_sample(charts[ErrorChart], record.error);
+			push_sample(charts[VoltageChart], record.left_voltage, record.right_voltage);
+			push_sample(charts[VelocityChart], record.setpoint_velocity, (record.left_velocity + record.right_velocity) / 2);
+		}
+	}
+
+	uint32_t now = pros::millis();
+
+	if(now - last_temperature >= diagnostics_config.temperature_period){
+		last_temperature = now;
+
+		robot.chassis.left_motors.sample(left_sample);
+		robot.chassis.right_motors.sample(right_sample);
+		double drive_temperature = std::max(left_sample.max_temperature, right_sample.max_temperature).in(au::celsius_qty);
+
+		double intake_temperature = 0;
+		pros::Motor* motors[3] = {&robot.intake.intake_motor, &robot.intake.intake_motor_2, &robot.intake.middle_motor};
+		for(pros::Motor* motor : motors){
+			double temperature = motor->get_temperature();
+			if(temperature != PROS_ERR_F){
+				intake_temperature = std::max(intake_temperature, temperature);
+			}
+		}
+
+		push_sample(charts[TemperatureChart], drive_temperature, intake_temperature);
+	}
+
+	// samples keep being collected off screen, but the charts are only redrawn while they can be seen
+	if(now - last_redraw < diagnostics_config.redraw_period || !lv_obj_is_visible(charts[ErrorChart].chart)){
+		return;
+	}
+	last_redraw = now;
+
+	for(DiagnosticChart& chart : charts){
+		redraw_chart(chart);
+	}
+}
@@ -0,0 +1,328 @@
+#include "subsystems/field_map.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+
+// the most recent poses kept in the trail, when full the oldest half is dropped
+static constexpr size_t trail_capacity = 512;
+// the radius of the robot marker (px)
+static constexpr lv_coord_t marker_radius = 5;
+
+struct MapPoint {
+	lv_coord_t x;
+	lv_coord_t y;
+};
+
+static FieldMapConfig map_config;
+
+// the canvas draws straight from this buffer, pixels are written directly so only the
+// area around each change is invalidated (lv_canvas_draw_* and set_px invalidate the whole canvas)
+static lv_color_t map_buffer[max_field_map_size * max_field_map_size];
+
+static lv_obj_t * map_canvas = nullptr;
+static lv_obj_t * robot_marker;
+static lv_obj_t * heading_line;
+static lv_obj_t * path_error_label;
+
+static lv_style_t marker_style;
+static lv_style_t heading_style;
+
+static lv_point_t heading_points[2];
+
+static const lv_color_t field_color = lv_color_make(45, 45, 50);
+static const lv_color_t tile_color = lv_color_make(75, 75, 80);
+static const lv_color_t path_color = lv_color_make(255, 152, 0);
+static const lv_color_t trail_color = lv_color_make(0, 188, 212);
+
+static MapPoint trail[trail_capacity];
+static size_t trail_length = 0;
+// where the last trail point was recorded, in field coordinates (m)
+static double trail_x = NAN;
+static double trail_y = NAN;
+static std::atomic<bool> trail_clear_requested{false};
+
+// a copy of the robot's path, taken whenever its version changes
+static std::array<std::pair<double, double>, Robot::max_path_points> path{};
+static size_t path_length = 0;
+static uint32_t displayed_path_version = UINT32_MAX;
+
+// the last values drawn, widgets are only touched when these change
+static MapPoint displayed_marker = {-1, -1};
+static MapPoint displayed_heading = {-1, -1};
+static int32_t displayed_path_error = -2;
+
+static MapPoint to_pixel(double x, double y){
+	double scale = map_config.size / map_config.field_size;
+
+	// screen y grows downwards
+	return {
+		(lv_coord_t)std::lround((map_config.origin_x + x) * scale),
+		(lv_coord_t)std::lround(map_config.size - 1 - (map_config.origin_y + y) * scale)
+	};
+}
+
+static void put_pixel(lv_coord_t x, lv_coord_t y, lv_color_t color){
+	if(x < 0 || y < 0 || x >= map_config.size || y >= map_config.size){
+		return;
+	}
+
+	map_buffer[y * map_config.size + x] = color;
+}
+
+static void draw_line(MapPoint start, MapPoint end, lv_color_t color){
+	// bresenham's line algorithm
+	lv_coord_t dx = std::abs(end.x - start.x);
+	lv_coord_t dy = -std::abs(end.y - start.y);
+	lv_coord_t step_x = start.x < end.x ? 1 : -1;
+	lv_coord_t step_y = start.y < end.y ? 1 : -1;
+	lv_coord_t error = dx + dy;
+
+	MapPoint point = start;
+
+	while(true){
+		put_pixel(point.x, point.y, color);
+
+		if(point.x == end.x && point.y == end.y){
+			break;
+		}
+
+		lv_coord_t doubled = 2 * error;
+		if(doubled >= dy){
+			error += dy;
+			point.x += step_x;
+		}
+		if(doubled <= dx){
+			error += dx;
+			point.y += step_y;
+		}
+	}
+}
+
+static void invalidate_pixels(MapPoint start, MapPoint end){
+	lv_area_t coords;
+	lv_obj_get_coords(map_canvas, &coords);
+
+	// invalidated areas are in screen coordinates
+	lv_area_t area = {
+		(lv_coord_t)(coords.x1 + std::min(start.x, end.x)),
+		(lv_coord_t)(coords.y1 + std::min(start.y, end.y)),
+		(lv_coord_t)(coords.x1 + std::max(start.x, end.x)),
+		(lv_coord_t)(coords.y1 + std::max(start.y, end.y))
+	};
+	lv_obj_invalidate_area(map_canvas, &area);
+}
+
+static void draw_background(){
+	std::fill(map_buffer, map_buffer + map_config.size * map_config.size, field_color);
+
+	// the field is 6 tiles across
+	for(int i = 0; i <= 6; i++){
+		lv_coord_t offset = std::min<lv_coord_t>(map_config.size * i / 6, map_config.size - 1);
+		draw_line({offset, 0}, {offset, (lv_coord_t)(map_config.size - 1)}, tile_color);
+		draw_line({0, offset}, {(lv_coord_t)(map_config.size - 1), offset}, tile_color);
+	}
+}
+
+static void draw_path(){
+	for(size_t i = 0; i < path_length; i++){
+		MapPoint point = to_pixel(path[i].first, path[i].second);
+
+		if(i > 0){
+			draw_line(to_pixel(path[i - 1].first, path[i - 1].second), point, path_color);
+		}
+
+		// mark each target with a small square
+		for(lv_coord_t dx = -1; dx <= 1; dx++){
+			for(lv_coord_t dy = -1; dy <= 1; dy++){
+				put_pixel(point.x + dx, point.y + dy, path_color);
+			}
+		}
+	}
+}
+
+static void draw_trail(){
+	for(size_t i = 1; i < trail_length; i++){
+		draw_line(trail[i - 1], trail[i], trail_color);
+	}
+}
+
+static void repaint(){
+	draw_background();
+	draw_path();
+	draw_trail();
+	lv_obj_invalidate(map_canvas);
+}
+
+// the shortest distance from the pose to any segment of the path (m)
+static double path_error(double x, double y){
+	double closest = INFINITY;
+
+	if(path_length == 1){
+		return std::hypot(x - path[0].first, y - path[0].second);
+	}
+
+	for(size_t i = 1; i < path_length; i++){
+		double start_x = path[i - 1].first;
+		double start_y = path[i - 1].second;
+		double segment_x = path[i].first - start_x;
+		double segment_y = path[i].second - start_y;
+		double length_squared = segment_x * segment_x + segment_y * segment_y;
+
+		// project the pose onto the segment, clamped to its end points
+		double t = 0;
+		if(length_squared > 0){
+			t = std::clamp(((x - start_x) * segment_x + (y - start_y) * segment_y) / length_squared, 0.0, 1.0);
+		}
+
+		closest = std::min(closest, std::hypot(x - (start_x + t * segment_x), y - (start_y + t * segment_y)));
+	}
+
+	return closest;
+}
+
+void create_field_map(lv_obj_t * parent, FieldMapConfig config){
+	if(map_canvas != nullptr){
+		return;
+	}
+
+	config.size = std::clamp<lv_coord_t>(config.size, 1, max_field_map_size);
+	map_config = config;
+
+	map_canvas = lv_canvas_create(parent);
+	lv_canvas_set_buffer(map_canvas, map_buffer, map_config.size, map_config.size, LV_IMG_CF_TRUE_COLOR);
+	lv_obj_clear_flag(map_canvas, LV_OBJ_FLAG_SCROLLABLE);
+
+	lv_style_init(&marker_style);
+	lv_style_set_radius(&marker_style, LV_RADIUS_CIRCLE);
+	lv_style_set_bg_opa(&marker_style, LV_OPA_COVER);
+	lv_style_set_bg_color(&marker_style, lv_color_white());
+
+	lv_style_init(&heading_style);
+	lv_style_set_line_width(&heading_style, 2);
+	lv_style_set_line_color(&heading_style, lv_palette_main(LV_PALETTE_RED));
+
+	// the robot is drawn on top of the canvas, so moving it only redraws its old & new area
+	robot_marker = lv_obj_create(map_canvas);
+	lv_obj_remove_style_all(robot_marker);
+	lv_obj_add_style(robot_marker, &marker_style, 0);
+	lv_obj_set_size(robot_marker, 2 * marker_radius + 1, 2 * marker_radius + 1);
+	lv_obj_clear_flag(robot_marker, LV_OBJ_FLAG_CLICKABLE);
+	lv_obj_add_flag(robot_marker, LV_OBJ_FLAG_HIDDEN);
+
+	heading_line = lv_line_create(map_canvas);
+	lv_obj_add_style(heading_line, &heading_style, 0);
+	lv_obj_set_size(heading_line, 2 * marker_radius + 1, 2 * marker_radius + 1);
+	lv_obj_add_flag(heading_line, LV_OBJ_FLAG_HIDDEN);
+
+	path_error_label = lv_label_create(parent);
+	lv_label_set_text(path_error_label, "Path error: --");
+
+	repaint();
+}
+
+void update_field_map(Robot& robot){
+	if(map_canvas == nullptr){
+		return;
+	}
+
+	dlib::Pose2d pose = robot.odom.get_position();
+	double x = pose.x.in(meters);
+	double y = pose.y.in(meters);
+	double theta = pose.theta.in(radians);
+
+	bool needs_repaint = false;
+
+	// the path is written by the autonomous task, a copy is only kept if no write started or finished
+	// while it was read, after a few tries the old path stays up until the next update
+	for(size_t attempt = 0; attempt < 3; attempt++){
+		uint32_t version = robot.path_version.load(std::memory_order_acquire);
+		if(version == displayed_path_version){
+			break;
+		}
+		if(version % 2 != 0){
+			continue;
+		}
+
+		size_t length = std::min(robot.path_length.load(std::memory_order_relaxed), Robot::max_path_points);
+		auto points = robot.path_points;
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if(robot.path_version.load(std::memory_order_relaxed) == version){
+			path = points;
+			path_length = length;
+			displayed_path_version = version;
+			needs_repaint = true;
+			break;
+		}
+	}
+
+	if(trail_clear_requested.exchange(false)){
+		trail_length = 0;
+		trail_x = NAN;
+		needs_repaint = true;
+	}
+
+	if(std::isnan(trail_x) || std::hypot(x - trail_x, y - trail_y) >= map_config.trail_spacing){
+		trail_x = x;
+		trail_y = y;
+
+		if(trail_length == trail_capacity){
+			std::copy(trail + trail_capacity / 2, trail + trail_capacity, trail);
+			trail_length = trail_capacity / 2;
+			needs_repaint = true;
+		}
+
+		trail[trail_length] = to_pixel(x, y);
+		trail_length++;
+
+		// a new segment is drawn on top of what is already there
+		if(!needs_repaint && trail_length >= 2){
+			draw_line(trail[trail_length - 2], trail[trail_length - 1], trail_color);
+			invalidate_pixels(trail[trail_length - 2], trail[trail_length - 1]);
+		}
+	}
+
+	if(needs_repaint){
+		repaint();
+	}
+
+	MapPoint marker = to_pixel(x, y);
+	MapPoint heading = {
+		(lv_coord_t)std::lround(marker_radius + marker_radius * std::cos(theta)),
+		(lv_coord_t)std::lround(marker_radius - marker_radius * std::sin(theta))
+	};
+
+	if(marker.x != displayed_marker.x || marker.y != displayed_marker.y){
+		displayed_marker = marker;
+		lv_obj_set_pos(robot_marker, marker.x - marker_radius, marker.y - marker_radius);
+		lv_obj_set_pos(heading_line, marker.x - marker_radius, marker.y - marker_radius);
+		lv_obj_clear_flag(robot_marker, LV_OBJ_FLAG_HIDDEN);
+		lv_obj_clear_flag(heading_line, LV_OBJ_FLAG_HIDDEN);
+	}
+
+	if(heading.x != displayed_heading.x || heading.y != displayed_heading.y){
+		displayed_heading = heading;
+		heading_points[0] = {marker_radius, marker_radius};
+		heading_points[1] = {heading.x, heading.y};
+		lv_line_set_points(heading_line, heading_points, 2);
+	}
+
+	// shown in whole millimeters, -1 when there is no path
+	int32_t error = path_length == 0 ? -1 : (int32_t)std::lround(path_error(x, y) * 1000);
+
+	if(error != displayed_path_error){
+		displayed_path_error = error;
+
+		if(error < 0){
+			lv_label_set_text(path_error_label, "Path error: --");
+		}
+		else{
+			lv_label_set_text_fmt(path_error_label, "Path error: %d.%d cm", (int)(error / 10), (int)(error % 10));
+		}
+	}
+}
+
+void clear_field_map_trail(){
+	trail_clear_requested = true;
+}
@@ -1,10 +1,14 @@
 #include "subsystems/intake.hpp"
+#include <algorithm>
+#include <cmath>
+#include <mutex>
 
 Intake::Intake(
     int8_t motor_port,
     int8_t bottom_motor,
-    int8_t middle_motor_p
-) : intake_motor(motor_port), intake_motor_2(bottom_motor), middle_motor(middle_motor_p) 
+    int8_t middle_motor_p,
+    IntakeJamConfig jam_config
+) : intake_motor(motor_port), intake_motor_2(bottom_motor), middle_motor(middle_motor_p), jam_config(jam_config)
 {   
     // initialize the stuff (can be changed during runtime)
     intake_motor.set_gearing(pros::E_MOTOR_GEAR_BLUE);
@@ -12,44 +16,56 @@ Intake::Intake(
     middle_motor.set_gearing(pros::E_MOTOR_GEAR_BLUE);
 };
 
+Intake::Intake(const Intake& other)
+    : Intake(other.intake_motor.get_port(), other.intake_motor_2.get_port(), other.middle_motor.get_port(), other.jam_config)
+{
+    alliance = other.alliance;
+    do_sort = other.do_sort;
+    direction = other.direction;
+    voltage_limit = other.voltage_limit;
+}
+
 void Intake::set_alliance(Alliance alliance){
     this->alliance = alliance;
 }
 
 void Intake::move(uint8_t power){
-    intake_motor.move(power);
-    intake_motor_2.move(power);
-    middle_motor.move(power);
+    // recorded like every other command so the intake task keeps sending it
+    int32_t millivolts = std::min<int32_t>(power, 127) * 12000 / 127;
+
+    command(0, millivolts);
+    command(1, millivolts);
+    command(2, millivolts);
 }
 
 void Intake::move_voltage(ushort voltage){
-    intake_motor.move_voltage(voltage);
+    command(0, voltage);
 }
 
 void Intake::max(void){
-    intake_motor.move_voltage(12000);
-    intake_motor_2.move_voltage(12000);
-    middle_motor.move_voltage(12000);
+    command(0, 12000);
+    command(1, 12000);
+    command(2, 12000);
 }
 
 void Intake::bottom_max_top_rev(void){
-    intake_motor.move_voltage(3000);
-    intake_motor_2.move_voltage(12000);
+    command(0, 3000);
+    command(1, 12000);
 }
 
 void Intake::bottom_rev(void){
-    intake_motor_2.move_voltage(12000);
+    command(1, 12000);
 }
 
 void Intake::reverse(void){
-    intake_motor.move_voltage(-12000);
-    intake_motor_2.move_voltage(-12000);
+    command(0, -12000);
+    command(1, -12000);
 }
 
 void Intake::stop(void){
-    intake_motor.brake();
-    intake_motor_2.brake();
-    middle_motor.brake();
+    command(0, 0);
+    command(1, 0);
+    command(2, 0);
 }
 
 void Intake::toggle_color_sort(void){
@@ -60,4 +76,189 @@ void Intake::toggle_direction(void){
     direction *= -1;
 
     //forward: 1 reverse: -1
-}
\ No newline at end of file
+}
+
+void Intake::set_voltage_limit(int32_t millivolts){
+    std::lock_guard<pros::Mutex> guard(mutex);
+    voltage_limit = std::clamp<int32_t>(millivolts, 0, 12000);
+}
+
+int32_t Intake::limit_voltage(int32_t millivolts){
+    return std::clamp(millivolts, -voltage_limit, voltage_limit);
+}
+
+void Intake::update(void){
+    std::lock_guard<pros::Mutex> guard(mutex);
+    uint32_t now = pros::millis();
+
+    switch(state){
+        case IntakeState::Running: {
+            // give the motors time to spin up before judging them
+            if(now - command_start < jam_config.spin_up_time){
+                break;
+            }
+
+            bool jammed = false;
+
+            for(size_t i = 0; i < 3; i++){
+                // keep the last command at most one tick behind the power manager's limit
+                send(i, commanded[i]);
+
+                // the eject motor is deliberately driven against its command
+                if(std::abs(commanded[i]) < jam_config.min_voltage || (ejecting && i == eject_motor)){
+                    stalled_ticks[i] = 0;
+                    continue;
+                }
+
+                double velocity = motor(i).get_actual_velocity();
+                if(velocity == PROS_ERR_F){
+                    stalled_ticks[i] = 0;
+                    continue;
+                }
+
+                // velocity in the commanded direction
+                if(commanded[i] < 0){
+                    velocity = -velocity;
+                }
+
+                if(velocity < jam_config.jam_velocity){
+                    stalled_ticks[i]++;
+                }
+                else {
+                    stalled_ticks[i] = 0;
+                }
+
+                jammed = jammed || stalled_ticks[i] >= jam_config.jam_ticks;
+            }
+
+            if(jammed){
+                unjam_attempts++;
+
+                if(unjam_attempts > jam_config.max_attempts){
+                    set_state(IntakeState::Faulted);
+                    for(size_t i = 0; i < 3; i++){
+                        send(i, 0);
+                    }
+                }
+                else {
+                    set_state(IntakeState::Unjamming);
+                }
+            }
+            // spun up cleanly, the jam is gone
+            else if(now - command_start >= 2 * jam_config.spin_up_time){
+                unjam_attempts = 0;
+            }
+
+            break;
+        }
+        case IntakeState::Unjamming: {
+            if(now - state_start < jam_config.reverse_time){
+                // back every driven motor off, re-sent each tick in case a command raced us
+                for(size_t i = 0; i < 3; i++){
+                    if(commanded[i] != 0){
+                        send(i, commanded[i] > 0 ? -12000 : 12000);
+                    }
+                }
+                break;
+            }
+
+            // resume the last command
+            set_state(IntakeState::Running);
+            command_start = now;
+
+            for(size_t i = 0; i < 3; i++){
+                send(i, commanded[i]);
+            }
+
+            break;
+        }
+        case IntakeState::Faulted: {
+            break;
+        }
+    }
+}
+
+IntakeState Intake::get_state(void){
+    std::lock_guard<pros::Mutex> guard(mutex);
+    return state;
+}
+
+pros::Motor& Intake::motor(size_t index){
+    switch(index){
+        case 0: return intake_motor;
+        case 1: return intake_motor_2;
+        default: return middle_motor;
+    }
+}
+
+void Intake::command(size_t index, int32_t millivolts){
+    std::lock_guard<pros::Mutex> guard(mutex);
+
+    if(commanded[index] == millivolts){
+        // the driver loop repeats the same command every tick, only resend it while running
+        if(state == IntakeState::Running){
+            send(index, millivolts);
+        }
+        return;
+    }
+
+    // a new command restarts spin up, and clears a fault
+    commanded[index] = millivolts;
+    stalled_ticks[index] = 0;
+    command_start = pros::millis();
+
+    if(state == IntakeState::Faulted){
+        unjam_attempts = 0;
+        set_state(IntakeState::Running);
+    }
+
+    if(state == IntakeState::Running){
+        send(index, millivolts);
+    }
+}
+
+void Intake::start_eject(size_t motor_index, int32_t millivolts){
+    std::lock_guard<pros::Mutex> guard(mutex);
+
+    eject_motor = motor_index;
+    eject_voltage = millivolts;
+    ejecting = true;
+
+    send(eject_motor, eject_voltage);
+}
+
+void Intake::stop_eject(void){
+    std::lock_guard<pros::Mutex> guard(mutex);
+
+    ejecting = false;
+    stalled_ticks[eject_motor] = 0;
+
+    // let the motor spin back up before looking for jams
+    command_start = pros::millis();
+
+    if(state == IntakeState::Running){
+        send(eject_motor, commanded[eject_motor]);
+    }
+}
+
+void Intake::send(size_t index, int32_t millivolts){
+    if(ejecting && index == eject_motor){
+        millivolts = eject_voltage;
+    }
+
+    if(millivolts == 0){
+        motor(index).brake();
+    }
+    else {
+        motor(index).move_voltage(limit_voltage(millivolts));
+    }
+}
+
+void Intake::set_state(IntakeState state){
+    this->state = state;
+    state_start = pros::millis();
+
+    for(size_t i = 0; i < 3; i++){
+        stalled_ticks[i] = 0;
+    }
+}
@@ -0,0 +1,75 @@
+#include "subsystems/power_manager.hpp"
+
+PowerManager::PowerManager(
+    dlib::Chassis& chassis,
+    Intake& intake,
+    PowerManagerConfig config
+) : chassis(chassis), intake(intake), config(config), drive_limiter(config.drive_thermal), intake_limiter(config.intake_thermal)
+{
+
+};
+
+void PowerManager::update(void){
+    auto period = au::milli(au::seconds)(static_cast<double>(config.update_period));
+
+    // drive: both sides share the hottest motor's scale so the robot still drives straight
+    chassis.left_motors.sample(left_sample);
+    chassis.right_motors.sample(right_sample);
+
+    auto drive_temperature = std::max(left_sample.max_temperature, right_sample.max_temperature);
+    auto drive_scale = drive_limiter.update(drive_temperature, period);
+
+    chassis.left_motors.set_voltage_limit(au::volts(12.0) * drive_scale);
+    chassis.right_motors.set_voltage_limit(au::volts(12.0) * drive_scale);
+
+    // intake
+    pros::Motor* motors[3] = {&intake.intake_motor, &intake.intake_motor_2, &intake.middle_motor};
+    double intake_temperature = 0;
+
+    for(int i = 0; i < 3; i++){
+        auto temperature = motors[i]->get_temperature();
+        auto current = motors[i]->get_current_draw();
+        auto velocity = motors[i]->get_actual_velocity();
+
+        if(temperature == PROS_ERR_F || current == PROS_ERR || velocity == PROS_ERR_F){
+            continue;
+        }
+
+        intake_temperature = std::max(intake_temperature, temperature);
+
+        // high current with no movement means the motor is pushing against a jam
+        if(current >= config.jam_current && std::abs(velocity) <= config.jam_velocity){
+            jam_timers[i] += config.update_period;
+        }
+        else if(std::abs(velocity) > config.jam_velocity){
+            jam_timers[i] = 0;
+        }
+
+        bool is_jammed = jam_timers[i] >= config.jam_time;
+
+        if(is_jammed != jammed[i]){
+            jammed[i] = is_jammed;
+            motors[i]->set_current_limit(is_jammed ? config.jammed_current_limit : config.normal_current_limit);
+        }
+    }
+
+    auto intake_scale = intake_limiter.update(au::celsius_qty(intake_temperature), period);
+    intake.set_voltage_limit(12000 * intake_scale);
+}
+
+void PowerManager::start(void){
+    task = std::make_unique<pros::Task>([this](){
+        while(true){
+            update();
+            pros::delay(config.update_period);
+        }
+    });
+}
+
+double PowerManager::get_drive_scale(void){
+    return drive_limiter.get_scale();
+}
+
+double PowerManager::get_intake_scale(void){
+    return intake_limiter.get_scale();
+}
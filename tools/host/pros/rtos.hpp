@@ -0,0 +1,39 @@
+#pragma once
+
+// rtos.hpp
+//
+// The parts of the PROS RTOS that the header-only dlib controllers and Odometry use,
+// so they can be built unchanged on a Linux host. Put tools/host before include on
+// the include path.
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+
+namespace pros {
+
+class Mutex {
+public:
+    Mutex() = default;
+    Mutex(const Mutex&) = delete;
+    Mutex(Mutex&&) = delete;
+
+    bool take() { raw.lock(); return true; }
+    bool take(std::uint32_t) { raw.lock(); return true; }
+    bool give() { raw.unlock(); return true; }
+
+    void lock() { raw.lock(); }
+    void unlock() { raw.unlock(); }
+    bool try_lock() { return raw.try_lock(); }
+
+private:
+    std::mutex raw;
+};
+
+inline std::uint32_t millis() {
+    static auto start = std::chrono::steady_clock::now();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return static_cast<std::uint32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count());
+}
+
+}
@@ -0,0 +1,311 @@
+// log_analyzer.cpp
+//
+// Computes per-motion controller metrics from the .dlog files written by dlib::SdLogger,
+// and aggregates them across runs to find the slowest motions of a routine.
+//
+// Build from the repository root:
+//   g++ -std=c++20 -O2 -Iinclude -o log_analyzer tools/log_analyzer.cpp
+//
+// Usage:
+//   ./log_analyzer [--metrics metrics.csv] [--traces directory] run_0.dlog run_1.dlog ...
+//
+// --metrics writes one row per motion of every run. Rise, overshoot & settle are measured
+// against the motion's final target, tracking_rms against the setpoint the controller saw.
+// --traces writes a csv per run with the pose path and setpoint vs measured velocity of every tick.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+#include "telemetry_log.hpp"
+
+struct MotionMetrics {
+    std::string run;
+    uint16_t motion;
+    dlib::TelemetryMotion kind;
+    bool profiled;
+    uint8_t exit_state;
+
+    // seconds
+    double duration = 0;
+    double rise_time = NAN;
+    double settle_time = NAN;
+
+    // meters for linear motions, degrees for turns, measured against the motion's final target
+    double initial_error = 0;
+    double overshoot = 0;
+    double steady_state_error = 0;
+    // the error the controller saw, against the profile's setpoint for profiled motions
+    double tracking_rms = 0;
+
+    // meters per second, setpoint vs measured velocity, only for profiled motions
+    double velocity_tracking_rms = NAN;
+};
+
+// the error band a motion must stay inside to count as settled
+constexpr double linear_settle_band = 0.0254;
+constexpr double angular_settle_band = 1.0;
+// the fraction of the initial error left when the motion has risen
+constexpr double rise_fraction = 0.1;
+// the final stretch of a motion averaged for the steady state error, seconds
+constexpr double steady_state_window = 0.2;
+
+static const char* kind_name(dlib::TelemetryMotion kind) {
+    switch (kind) {
+        case dlib::TelemetryMotion::Linear: return "linear";
+        case dlib::TelemetryMotion::Angular: return "angular";
+        default: return "none";
+    }
+}
+
+static const char* state_name(uint8_t state) {
+    switch (state) {
+        case 0: return "running";
+        case 1: return "settled";
+        case 2: return "timed_out";
+        case 3: return "stalled";
+        default: return "unknown";
+    }
+}
+
+static double seconds_between(const dlib::TelemetryRecord& from, const dlib::TelemetryRecord& to) {
+    return (to.timestamp - from.timestamp) / 1000.0;
+}
+
+// the error from the motion's final target. The logged error of a profiled motion is
+// against the moving setpoint, so it is rebuilt from the last setpoint & the measured position
+static double target_error(const dlib::TelemetryRecord& record, const dlib::TelemetryRecord& last, bool profiled) {
+    if (!profiled) {
+        return record.error;
+    }
+
+    double measured = (record.left_displacement + record.right_displacement) / 2;
+    return last.setpoint_position - measured;
+}
+
+static MotionMetrics analyze(const TelemetryLog& log, TelemetryMotionSpan span) {
+    auto& first = log.records[span.begin];
+    auto& last = log.records[span.end - 1];
+
+    MotionMetrics metrics;
+    metrics.run = log.path;
+    metrics.motion = first.motion;
+    metrics.kind = static_cast<dlib::TelemetryMotion>(first.kind);
+    metrics.profiled = dlib::telemetry_profiled(static_cast<dlib::TelemetryController>(first.controller));
+    metrics.exit_state = last.state;
+    metrics.duration = seconds_between(first, last);
+    metrics.initial_error = target_error(first, last, metrics.profiled);
+
+    double band = metrics.kind == dlib::TelemetryMotion::Linear ? linear_settle_band : angular_settle_band;
+    double sign = metrics.initial_error >= 0 ? 1 : -1;
+    size_t last_outside_band = span.begin;
+
+    double steady_state_sum = 0;
+    size_t steady_state_count = 0;
+    double tracking_sum = 0;
+    double velocity_tracking_sum = 0;
+    size_t tracking_count = 0;
+
+    for (size_t i = span.begin; i < span.end; i++) {
+        auto& record = log.records[i];
+        double error = target_error(record, last, metrics.profiled);
+
+        if (std::isnan(metrics.rise_time) && std::abs(error) <= rise_fraction * std::abs(metrics.initial_error)) {
+            metrics.rise_time = seconds_between(first, record);
+        }
+
+        // error with the opposite sign of the starting error is past the target
+        if (error * sign < 0) {
+            metrics.overshoot = std::max(metrics.overshoot, std::abs(error));
+        }
+
+        if (std::abs(error) > band) {
+            last_outside_band = i;
+        }
+
+        if (seconds_between(record, last) <= steady_state_window) {
+            steady_state_sum += std::abs(error);
+            steady_state_count++;
+        }
+
+        tracking_sum += record.error * record.error;
+
+        // profiled motions also track the profile's velocity
+        double velocity_error = record.setpoint_velocity - (record.left_velocity + record.right_velocity) / 2;
+        velocity_tracking_sum += velocity_error * velocity_error;
+        tracking_count++;
+    }
+
+    if (std::abs(target_error(last, last, metrics.profiled)) <= band) {
+        size_t settled_index = std::min(last_outside_band + 1, span.end - 1);
+        metrics.settle_time = seconds_between(first, log.records[settled_index]);
+        if (std::abs(metrics.initial_error) <= band) {
+            metrics.settle_time = 0;
+        }
+    }
+
+    metrics.steady_state_error = steady_state_count ? steady_state_sum / steady_state_count : 0;
+    metrics.tracking_rms = tracking_count ? std::sqrt(tracking_sum / tracking_count) : 0;
+    if (metrics.profiled && tracking_count) {
+        metrics.velocity_tracking_rms = std::sqrt(velocity_tracking_sum / tracking_count);
+    }
+
+    return metrics;
+}
+
+static void write_trace(const TelemetryLog& log, const std::string& directory) {
+    std::string name = log.path.substr(log.path.find_last_of('/') + 1);
+    std::string path = directory + "/" + name + ".csv";
+
+    FILE* file = std::fopen(path.c_str(), "w");
+    if (!file) {
+        std::perror(path.c_str());
+        return;
+    }
+
+    std::fprintf(file, "time_s,motion,kind,x_m,y_m,theta_rad,setpoint_position,setpoint_velocity,measured_velocity,left_voltage,right_voltage,error\n");
+
+    for (auto& record : log.records) {
+        std::fprintf(file, "%.3f,%u,%s,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.3f,%.3f,%.4f\n",
+            record.timestamp / 1000.0,
+            record.motion,
+            kind_name(static_cast<dlib::TelemetryMotion>(record.kind)),
+            record.x, record.y, record.theta,
+            record.setpoint_position,
+            record.setpoint_velocity,
+            (record.left_velocity + record.right_velocity) / 2,
+            record.left_voltage, record.right_voltage,
+            record.error);
+    }
+
+    std::fclose(file);
+}
+
+static double percentile(std::vector<double> values, double fraction) {
+    if (values.empty()) {
+        return NAN;
+    }
+
+    std::sort(values.begin(), values.end());
+    return values[static_cast<size_t>(fraction * (values.size() - 1) + 0.5)];
+}
+
+int main(int argc, char** argv) {
+    std::string metrics_path;
+    std::string traces_directory;
+    std::vector<std::string> inputs;
+
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--metrics") == 0 && i + 1 < argc) {
+            metrics_path = argv[++i];
+        } else if (std::strcmp(argv[i], "--traces") == 0 && i + 1 < argc) {
+            traces_directory = argv[++i];
+        } else {
+            inputs.push_back(argv[i]);
+        }
+    }
+
+    if (inputs.empty()) {
+        std::fprintf(stderr, "usage: %s [--metrics metrics.csv] [--traces directory] run.dlog...\n", argv[0]);
+        return 1;
+    }
+
+    std::vector<MotionMetrics> all_metrics;
+    size_t runs = 0;
+
+    for (auto& input : inputs) {
+        TelemetryLog log;
+        if (!load_telemetry_log(input, log)) {
+            continue;
+        }
+        runs++;
+
+        for (auto span : split_motions(log)) {
+            all_metrics.push_back(analyze(log, span));
+        }
+
+        if (!traces_directory.empty()) {
+            write_trace(log, traces_directory);
+        }
+    }
+
+    if (!metrics_path.empty()) {
+        FILE* file = std::fopen(metrics_path.c_str(), "w");
+        if (!file) {
+            std::perror(metrics_path.c_str());
+            return 1;
+        }
+
+        std::fprintf(file, "run,motion,kind,exit,duration_s,rise_time_s,settle_time_s,initial_error,overshoot,steady_state_error,tracking_rms,velocity_tracking_rms\n");
+        for (auto& metrics : all_metrics) {
+            std::fprintf(file, "%s,%u,%s,%s,%.3f,%.3f,%.3f,%.4f,%.4f,%.4f,%.4f,%.4f\n",
+                metrics.run.c_str(), metrics.motion, kind_name(metrics.kind), state_name(metrics.exit_state),
+                metrics.duration, metrics.rise_time, metrics.settle_time,
+                metrics.initial_error, metrics.overshoot, metrics.steady_state_error, metrics.tracking_rms, metrics.velocity_tracking_rms);
+        }
+
+        std::fclose(file);
+    }
+
+    // the same motion index in every run is the same step of the routine
+    std::map<uint16_t, std::vector<const MotionMetrics*>> by_motion;
+    for (auto& metrics : all_metrics) {
+        by_motion[metrics.motion].push_back(&metrics);
+    }
+
+    struct MotionAggregate {
+        uint16_t motion;
+        const char* kind;
+        size_t count;
+        double mean_duration;
+        double p90_duration;
+        double mean_overshoot;
+        size_t not_settled;
+    };
+    std::vector<MotionAggregate> aggregates;
+
+    for (auto& [motion, runs_of_motion] : by_motion) {
+        std::vector<double> durations;
+        double overshoot = 0;
+        size_t not_settled = 0;
+
+        for (auto* metrics : runs_of_motion) {
+            durations.push_back(metrics->duration);
+            overshoot += metrics->overshoot;
+            not_settled += metrics->exit_state != 1;
+        }
+
+        double total = 0;
+        for (double duration : durations) {
+            total += duration;
+        }
+
+        aggregates.push_back({
+            motion,
+            kind_name(runs_of_motion.front()->kind),
+            runs_of_motion.size(),
+            total / durations.size(),
+            percentile(durations, 0.9),
+            overshoot / runs_of_motion.size(),
+            not_settled
+        });
+    }
+
+    std::sort(aggregates.begin(), aggregates.end(), [](auto& a, auto& b) {
+        return a.mean_duration > b.mean_duration;
+    });
+
+    std::printf("%zu runs, %zu motions\n\n", runs, all_metrics.size());
+    std::printf("%-7s %-8s %5s %10s %10s %10s %12s\n", "motion", "kind", "runs", "mean (s)", "p90 (s)", "overshoot", "not settled");
+
+    for (auto& aggregate : aggregates) {
+        std::printf("%-7u %-8s %5zu %10.3f %10.3f %10.4f %12zu\n",
+            aggregate.motion, aggregate.kind, aggregate.count,
+            aggregate.mean_duration, aggregate.p90_duration, aggregate.mean_overshoot, aggregate.not_settled);
+    }
+
+    return 0;
+}
@@ -0,0 +1,305 @@
+// replay.cpp
+//
+// Replays the sensor samples of a .dlog file written by dlib::SdLogger through the
+// dlib Odometry, Pid and Settler code on a Linux host, so a controller change can be
+// checked against recorded runs instead of on the field.
+//
+// Every Pid motion is replayed tick by tick with the gains of the controller that logged
+// it (linear_pid, angular_pid or precise_angular_pid). The Pid gets the logged error with
+// the same fixed period the robot passes it, so with the robot's gains the replayed
+// voltage matches the logged one up to the log's float precision. The replay is
+// open loop: the recorded robot doesn't respond to different gains, so compare voltages
+// and settle points, not the path the robot would have taken. Profiled motions
+// (move_feedforward, move_cascade) add feedforward to their Pid, so they are only
+// replayed through the settler.
+//
+// Build from the repository root:
+//   g++ -std=c++20 -O2 -Itools/host -Iinclude -o replay tools/replay.cpp
+//       src/dlib/kinematics/odometry.cpp src/dlib/utilities/error_calculation.cpp
+//
+// Usage:
+//   ./replay [--linear kp ki kd] [--angular kp ki kd] [--precise kp ki kd] [--feedforward kp ki kd]
+//            [--period ms] [--trace trace.csv] run.dlog
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include "au/au.hpp"
+#include "dlib/controllers/pid.hpp"
+#include "dlib/controllers/settler.hpp"
+#include "dlib/kinematics/odometry.hpp"
+#include "telemetry_log.hpp"
+
+using namespace au;
+
+// the robot's configs from main.cpp, override the gains from the command line to test a change
+static dlib::PidConfig linear_pid_config {{40, 0, 0}, volts(12)};
+static dlib::PidConfig angular_pid_config {{30, 0, 1.6}, volts(12)};
+static dlib::PidConfig precise_angular_pid_config {{0, 0, 0}, volts(12)};
+static dlib::PidConfig linear_feedforward_pid_config {{25, 0, 0}, volts(12)};
+
+static dlib::SettlerConfig<Meters> linear_settler_config {
+    inches(1),
+    meters_per_second(.1),
+    milli(seconds)(40.0),
+    seconds(3),
+    meters_per_second(.02)
+};
+
+static dlib::SettlerConfig<Degrees> angular_settler_config {
+    degrees(3),
+    degrees_per_second(20),
+    milli(seconds)(40.0),
+    seconds(2),
+    degrees_per_second(5)
+};
+
+static dlib::SettlerConfig<Degrees> precise_angular_settler_config {
+    degrees(1.5),
+    degrees_per_second(10),
+    milli(seconds)(60.0),
+    seconds(2),
+    degrees_per_second(5)
+};
+
+static const char* controller_name(dlib::TelemetryController controller) {
+    switch (controller) {
+        case dlib::TelemetryController::LinearPid: return "pid";
+        case dlib::TelemetryController::LinearFeedforward: return "feedforward";
+        case dlib::TelemetryController::LinearCascade: return "cascade";
+        case dlib::TelemetryController::AngularPid: return "turn";
+        case dlib::TelemetryController::PreciseAngularPid: return "turn_precise";
+        default: return "none";
+    }
+}
+
+struct ReplayResult {
+    size_t ticks = 0;
+    // when the replayed settler finished, seconds from the start of the motion
+    double settle_time = NAN;
+    dlib::SettleState settle_state = dlib::SettleState::Running;
+    // replayed vs logged controller voltage
+    double voltage_rms = 0;
+    double voltage_max = 0;
+    bool profiled = false;
+};
+
+static const char* state_name(dlib::SettleState state) {
+    switch (state) {
+        case dlib::SettleState::Running: return "running";
+        case dlib::SettleState::Settled: return "settled";
+        case dlib::SettleState::TimedOut: return "timed_out";
+        case dlib::SettleState::Stalled: return "stalled";
+    }
+    return "unknown";
+}
+
+// replay one motion through a Pid & Settler with the same units as the robot's controller
+template<typename Units>
+static ReplayResult replay_motion(
+    const TelemetryLog& log,
+    TelemetryMotionSpan span,
+    dlib::PidConfig pid_config,
+    dlib::SettlerConfig<Units> settler_config,
+    bool profiled,
+    Quantity<Seconds, double> period,
+    FILE* trace
+) {
+    dlib::Pid<Units> pid(pid_config);
+    dlib::Settler<Units> settler(settler_config);
+    pid.reset();
+    settler.reset();
+
+    ReplayResult result;
+    auto& first = log.records[span.begin];
+    result.profiled = profiled;
+
+    double squared_sum = 0;
+
+    for (size_t i = span.begin; i < span.end; i++) {
+        auto& record = log.records[i];
+        auto error = make_quantity<Units>(static_cast<double>(record.error));
+
+        // the robot's measured velocity, used for stall detection
+        Quantity<TimeDerivative<Units>, double> velocity = ZERO;
+        if constexpr (std::is_same_v<Units, Meters>) {
+            velocity = meters_per_second((record.left_velocity + record.right_velocity) / 2.0);
+        } else if (i > span.begin) {
+            auto& previous = log.records[i - 1];
+            double dt = (record.timestamp - previous.timestamp) / 1000.0;
+            if (dt > 0) {
+                velocity = degrees_per_second((record.rotation - previous.rotation) / dt);
+            }
+        }
+
+        auto voltage = pid.update(error, period);
+
+        // the linear controller drives both sides the same way, the turn controller drives them apart
+        double logged_voltage = std::is_same_v<Units, Meters>
+            ? (record.left_voltage + record.right_voltage) / 2.0
+            : (record.right_voltage - record.left_voltage) / 2.0;
+
+        double difference = voltage.in(volts) - logged_voltage;
+        if (!result.profiled) {
+            squared_sum += difference * difference;
+            result.voltage_max = std::fmax(result.voltage_max, std::fabs(difference));
+        }
+
+        if (!settler.is_done()) {
+            auto state = settler.update(error, pid.get_derivative(), velocity, period);
+            if (state != dlib::SettleState::Running) {
+                result.settle_state = state;
+                result.settle_time = (record.timestamp - first.timestamp) / 1000.0;
+            }
+        }
+
+        if (trace) {
+            std::fprintf(trace, "%.3f,%u,%.5f,%.4f,%.4f,%d\n",
+                record.timestamp / 1000.0, record.motion, record.error,
+                logged_voltage, voltage.in(volts), settler.is_done());
+        }
+
+        result.ticks++;
+    }
+
+    result.voltage_rms = result.ticks ? std::sqrt(squared_sum / result.ticks) : 0;
+
+    return result;
+}
+
+static bool parse_gains(int& i, int argc, char** argv, dlib::PidGains& gains) {
+    if (i + 3 >= argc) {
+        return false;
+    }
+
+    gains.kp = std::atof(argv[++i]);
+    gains.ki = std::atof(argv[++i]);
+    gains.kd = std::atof(argv[++i]);
+
+    return true;
+}
+
+int main(int argc, char** argv) {
+    std::string input;
+    std::string trace_path;
+    double period_ms = 20;
+
+    for (int i = 1; i < argc; i++) {
+        bool ok = true;
+
+        if (std::strcmp(argv[i], "--linear") == 0) {
+            ok = parse_gains(i, argc, argv, linear_pid_config.gains);
+        } else if (std::strcmp(argv[i], "--angular") == 0) {
+            ok = parse_gains(i, argc, argv, angular_pid_config.gains);
+        } else if (std::strcmp(argv[i], "--precise") == 0) {
+            ok = parse_gains(i, argc, argv, precise_angular_pid_config.gains);
+        } else if (std::strcmp(argv[i], "--feedforward") == 0) {
+            ok = parse_gains(i, argc, argv, linear_feedforward_pid_config.gains);
+        } else if (std::strcmp(argv[i], "--period") == 0 && i + 1 < argc) {
+            period_ms = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            trace_path = argv[++i];
+        } else {
+            input = argv[i];
+        }
+
+        if (!ok) {
+            input.clear();
+            break;
+        }
+    }
+
+    if (input.empty()) {
+        std::fprintf(stderr, "usage: %s [--linear kp ki kd] [--angular kp ki kd] [--precise kp ki kd] [--feedforward kp ki kd] [--period ms] [--trace trace.csv] run.dlog\n", argv[0]);
+        return 1;
+    }
+
+    TelemetryLog log;
+    if (!load_telemetry_log(input, log)) {
+        return 1;
+    }
+
+    FILE* trace = nullptr;
+    if (!trace_path.empty()) {
+        trace = std::fopen(trace_path.c_str(), "w");
+        if (!trace) {
+            std::perror(trace_path.c_str());
+            return 1;
+        }
+        std::fprintf(trace, "time_s,motion,error,logged_voltage,replayed_voltage,settled\n");
+    }
+
+    auto period = milli(seconds)(period_ms);
+
+    // odometry from the raw drive & imu samples, checked against the pose the robot logged
+    dlib::Odometry odom;
+    double max_pose_difference = 0;
+
+    for (auto& record : log.records) {
+        odom.update(
+            meters(static_cast<double>(record.left_displacement)),
+            meters(static_cast<double>(record.right_displacement)),
+            ZERO,
+            degrees(static_cast<double>(record.rotation))
+        );
+
+        auto pose = odom.get_position();
+        double difference = std::hypot(pose.x.in(meters) - record.x, pose.y.in(meters) - record.y);
+        max_pose_difference = std::fmax(max_pose_difference, difference);
+    }
+
+    std::printf("%s: %zu records\n", input.c_str(), log.records.size());
+    std::printf("odometry: max difference from the logged pose %.4f m\n\n", max_pose_difference);
+    std::printf("%-7s %-12s %6s %-10s %9s %-10s %9s %11s %11s\n",
+        "motion", "controller", "ticks", "logged", "time (s)", "replayed", "time (s)", "V rms diff", "V max diff");
+
+    for (auto span : split_motions(log)) {
+        auto& first = log.records[span.begin];
+        auto& last = log.records[span.end - 1];
+        auto controller = static_cast<dlib::TelemetryController>(first.controller);
+        bool profiled = dlib::telemetry_profiled(controller);
+
+        // each motion is replayed with the gains & settler of the controller that logged it
+        ReplayResult result;
+        switch (controller) {
+            case dlib::TelemetryController::LinearPid:
+            case dlib::TelemetryController::LinearCascade:
+                result = replay_motion<Meters>(log, span, linear_pid_config, linear_settler_config, profiled, period, trace);
+                break;
+            case dlib::TelemetryController::LinearFeedforward:
+                result = replay_motion<Meters>(log, span, linear_feedforward_pid_config, linear_settler_config, profiled, period, trace);
+                break;
+            case dlib::TelemetryController::AngularPid:
+                result = replay_motion<Degrees>(log, span, angular_pid_config, angular_settler_config, profiled, period, trace);
+                break;
+            case dlib::TelemetryController::PreciseAngularPid:
+                result = replay_motion<Degrees>(log, span, precise_angular_pid_config, precise_angular_settler_config, profiled, period, trace);
+                break;
+            default:
+                continue;
+        }
+
+        std::printf("%-7u %-12s %6zu %-10s %9.3f %-10s %9.3f",
+            first.motion,
+            controller_name(controller),
+            result.ticks,
+            state_name(static_cast<dlib::SettleState>(last.state)),
+            (last.timestamp - first.timestamp) / 1000.0,
+            state_name(result.settle_state),
+            result.settle_time);
+
+        if (result.profiled) {
+            std::printf(" %11s %11s\n", "profiled", "-");
+        } else {
+            std::printf(" %11.4f %11.4f\n", result.voltage_rms, result.voltage_max);
+        }
+    }
+
+    if (trace) {
+        std::fclose(trace);
+    }
+
+    return 0;
+}
@@ -0,0 +1,341 @@
+// telemetry_decoder.cpp
+//
+// Decodes the binary telemetry stream from dlib::TelemetryStream into a CSV file,
+// and optionally one raw little endian float64 file per channel for fast loading.
+//
+// Build from the repository root:
+//   g++ -std=c++20 -O2 -Iinclude -o telemetry_decoder tools/telemetry_decoder.cpp
+//       src/dlib/telemetry/cobs.cpp src/dlib/telemetry/telemetry_protocol.cpp
+//
+// Usage:
+//   stty -F /dev/ttyACM0 raw
+//   ./telemetry_decoder /dev/ttyACM0 run.csv [columns_directory]
+//
+// The input can also be a capture of the serial port saved to a file, or - for stdin.
+//
+// ./telemetry_decoder --check round trips messages through the COBS encoder and decoder,
+// and checks that malformed frames are rejected. Build with -fsanitize=address to also
+// catch reads past the end of a frame.
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "dlib/telemetry/cobs.hpp"
+#include "dlib/telemetry/telemetry_protocol.hpp"
+
+struct Channel {
+    std::string name;
+    std::string unit;
+    float resolution = 0;
+    int32_t value = 0;
+    FILE* column = nullptr;
+};
+
+struct Decoder {
+    std::vector<Channel> channels;
+    bool synced = false;
+    bool header_written = false;
+    uint32_t timestamp = 0;
+
+    FILE* csv = nullptr;
+    std::string columns_directory;
+    FILE* timestamp_column = nullptr;
+
+    uint64_t frames = 0;
+    uint64_t samples = 0;
+    uint64_t bad_frames = 0;
+
+    void write_header() {
+        std::fprintf(csv, "timestamp_ms");
+        for (auto& channel : channels) {
+            std::fprintf(csv, ",%s[%s]", channel.name.c_str(), channel.unit.c_str());
+        }
+        std::fprintf(csv, "\n");
+
+        if (!columns_directory.empty()) {
+            timestamp_column = std::fopen((columns_directory + "/timestamp_ms.u32").c_str(), "wb");
+            for (auto& channel : channels) {
+                channel.column = std::fopen((columns_directory + "/" + channel.name + ".f64").c_str(), "wb");
+            }
+        }
+
+        header_written = true;
+    }
+
+    void write_row() {
+        if (!header_written) {
+            write_header();
+        }
+
+        std::fprintf(csv, "%u", timestamp);
+        if (timestamp_column) {
+            std::fwrite(&timestamp, sizeof(timestamp), 1, timestamp_column);
+        }
+
+        for (auto& channel : channels) {
+            double value = channel.value * static_cast<double>(channel.resolution);
+            std::fprintf(csv, ",%.6g", value);
+
+            if (channel.column) {
+                std::fwrite(&value, sizeof(value), 1, channel.column);
+            }
+        }
+        std::fprintf(csv, "\n");
+
+        samples++;
+    }
+
+    bool decode_channel(const uint8_t* payload, size_t length) {
+        if (length < 1 + sizeof(float) + 2) {
+            return false;
+        }
+
+        uint8_t id = payload[0];
+        if (id >= dlib::telemetry_max_channels) {
+            return false;
+        }
+
+        float resolution;
+        std::memcpy(&resolution, &payload[1], sizeof(float));
+
+        const char* name = reinterpret_cast<const char*>(&payload[1 + sizeof(float)]);
+        size_t name_length = strnlen(name, length - 1 - sizeof(float));
+        if (1 + sizeof(float) + name_length + 1 >= length) {
+            return false;
+        }
+
+        const char* unit = name + name_length + 1;
+        size_t unit_length = strnlen(unit, length - 1 - sizeof(float) - name_length - 1);
+
+        // the columns are fixed once the header is written, a restarted robot needs a new output file
+        if (header_written) {
+            return id < channels.size();
+        }
+
+        if (channels.size() <= id) {
+            channels.resize(id + 1);
+        }
+        channels[id].name = std::string(name, name_length);
+        channels[id].unit = std::string(unit, unit_length);
+        channels[id].resolution = resolution;
+
+        return true;
+    }
+
+    bool decode_sample(const uint8_t* payload, size_t length, bool key) {
+        size_t read = 0;
+
+        if (key) {
+            if (length < sizeof(uint32_t)) {
+                return false;
+            }
+            std::memcpy(&timestamp, payload, sizeof(uint32_t));
+            read += sizeof(uint32_t);
+        } else {
+            // a delta is meaningless without the sample before it
+            if (!synced) {
+                return true;
+            }
+
+            uint32_t delta;
+            size_t used = dlib::read_varint(&payload[read], length - read, delta);
+            if (used == 0) {
+                return false;
+            }
+            timestamp += delta;
+            read += used;
+        }
+
+        if (read >= length) {
+            return false;
+        }
+        size_t count = payload[read++];
+
+        // wait until every channel has been described
+        if (count != channels.size() || count == 0) {
+            synced = false;
+            return true;
+        }
+        for (auto& channel : channels) {
+            if (channel.resolution <= 0) {
+                synced = false;
+                return true;
+            }
+        }
+
+        for (size_t id = 0; id < count; id++) {
+            uint32_t encoded;
+            size_t used = dlib::read_varint(&payload[read], length - read, encoded);
+            if (used == 0) {
+                return false;
+            }
+            read += used;
+
+            int32_t value = dlib::zigzag_decode(encoded);
+            channels[id].value = key ? value : channels[id].value + value;
+        }
+
+        synced = true;
+        write_row();
+
+        return true;
+    }
+
+    void decode_frame(const uint8_t* encoded, size_t length) {
+        if (length == 0) {
+            return;
+        }
+
+        uint8_t frame[dlib::cobs_max_encoded_length(dlib::telemetry_max_frame) + 1];
+        if (length > sizeof(frame)) {
+            bad_frames++;
+            synced = false;
+            return;
+        }
+
+        size_t frame_length = dlib::cobs_decode(encoded, length, frame);
+
+        // terminal text and corrupted frames fail here
+        if (frame_length < 2 || dlib::telemetry_crc8(frame, frame_length - 1) != frame[frame_length - 1]) {
+            bad_frames++;
+            synced = false;
+            return;
+        }
+
+        const uint8_t* payload = &frame[1];
+        size_t payload_length = frame_length - 2;
+        bool ok = false;
+
+        switch (static_cast<dlib::TelemetryFrame>(frame[0])) {
+            case dlib::TelemetryFrame::Channel: ok = decode_channel(payload, payload_length); break;
+            case dlib::TelemetryFrame::KeySample: ok = decode_sample(payload, payload_length, true); break;
+            case dlib::TelemetryFrame::DeltaSample: ok = decode_sample(payload, payload_length, false); break;
+        }
+
+        if (ok) {
+            frames++;
+        } else {
+            bad_frames++;
+            synced = false;
+        }
+    }
+
+    void close() {
+        if (timestamp_column) {
+            std::fclose(timestamp_column);
+        }
+        for (auto& channel : channels) {
+            if (channel.column) {
+                std::fclose(channel.column);
+            }
+        }
+    }
+};
+
+// returns the number of failed cases
+static int check_cobs() {
+    int failures = 0;
+
+    // every block length around the 254 byte limit, with and without zeros
+    for (size_t length = 0; length <= 600; length++) {
+        for (int pattern = 0; pattern < 3; pattern++) {
+            std::vector<uint8_t> message(length);
+            for (size_t i = 0; i < length; i++) {
+                message[i] = pattern == 0 ? 0 : pattern == 1 ? static_cast<uint8_t>(i % 255 + 1) : static_cast<uint8_t>(i * 37 % 7);
+            }
+
+            std::vector<uint8_t> encoded(dlib::cobs_max_encoded_length(length));
+            size_t encoded_length = dlib::cobs_encode(message.data(), length, encoded.data());
+            encoded.resize(encoded_length);
+
+            std::vector<uint8_t> decoded(encoded_length);
+            size_t decoded_length = dlib::cobs_decode(encoded.data(), encoded_length, decoded.data());
+            decoded.resize(decoded_length);
+
+            bool has_zero = std::memchr(encoded.data(), 0, encoded_length) != nullptr;
+            if (has_zero || (length > 0 && decoded != message)) {
+                std::fprintf(stderr, "round trip failed: length %zu pattern %d\n", length, pattern);
+                failures++;
+            }
+        }
+    }
+
+    // sized exactly, so a read past the end is caught by the sanitizer
+    const std::vector<std::vector<uint8_t>> malformed = {
+        {0x02},
+        {0x05, 0x01, 0x02},
+        {0x00},
+        {0x03, 0x01, 0x00},
+        {0x01, 0x04, 0x01},
+    };
+
+    for (size_t i = 0; i < malformed.size(); i++) {
+        std::vector<uint8_t> encoded = malformed[i];
+        std::vector<uint8_t> decoded(encoded.size());
+
+        if (dlib::cobs_decode(encoded.data(), encoded.size(), decoded.data()) != 0) {
+            std::fprintf(stderr, "malformed frame %zu was accepted\n", i);
+            failures++;
+        }
+    }
+
+    std::fprintf(stderr, "cobs check: %d failures\n", failures);
+    return failures;
+}
+
+int main(int argc, char** argv) {
+    if (argc == 2 && std::strcmp(argv[1], "--check") == 0) {
+        return check_cobs() == 0 ? 0 : 1;
+    }
+
+    if (argc < 3) {
+        std::fprintf(stderr, "usage: %s <input|-> <output.csv> [columns_directory]\n       %s --check\n", argv[0], argv[0]);
+        return 1;
+    }
+
+    FILE* input = std::strcmp(argv[1], "-") == 0 ? stdin : std::fopen(argv[1], "rb");
+    if (!input) {
+        std::perror(argv[1]);
+        return 1;
+    }
+
+    Decoder decoder;
+    decoder.csv = std::fopen(argv[2], "w");
+    if (!decoder.csv) {
+        std::perror(argv[2]);
+        return 1;
+    }
+    if (argc > 3) {
+        decoder.columns_directory = argv[3];
+    }
+
+    std::vector<uint8_t> pending;
+    uint8_t chunk[4096];
+    size_t read;
+
+    while ((read = std::fread(chunk, 1, sizeof(chunk), input)) > 0) {
+        for (size_t i = 0; i < read; i++) {
+            if (chunk[i] == 0) {
+                decoder.decode_frame(pending.data(), pending.size());
+                pending.clear();
+            } else if (pending.size() < 4096) {
+                pending.push_back(chunk[i]);
+            }
+        }
+
+        // keep the csv current when reading from a live port
+        std::fflush(decoder.csv);
+    }
+
+    decoder.close();
+    std::fclose(decoder.csv);
+
+    std::fprintf(stderr, "%llu frames, %llu samples, %llu bad frames\n",
+        static_cast<unsigned long long>(decoder.frames),
+        static_cast<unsigned long long>(decoder.samples),
+        static_cast<unsigned long long>(decoder.bad_frames));
+
+    return 0;
+}
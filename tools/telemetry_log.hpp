@@ -0,0 +1,77 @@
+#pragma once
+
+// telemetry_log.hpp
+//
+// Loads the .dlog files written by dlib::SdLogger, shared by the host tools.
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "dlib/telemetry/telemetry_record.hpp"
+
+struct TelemetryLog {
+    std::string path;
+    std::vector<dlib::TelemetryRecord> records;
+};
+
+// every record of one motion, in order
+struct TelemetryMotionSpan {
+    size_t begin;
+    size_t end;
+};
+
+inline bool load_telemetry_log(const std::string& path, TelemetryLog& log) {
+    FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        std::perror(path.c_str());
+        return false;
+    }
+
+    dlib::TelemetryLogHeader header;
+    bool valid = std::fread(&header, sizeof(header), 1, file) == 1
+        && header.magic == dlib::telemetry_log_magic
+        && header.version == dlib::telemetry_log_version
+        && header.record_size == sizeof(dlib::TelemetryRecord);
+
+    if (!valid) {
+        std::fprintf(stderr, "%s: not a version %u telemetry log\n", path.c_str(), dlib::telemetry_log_version);
+        std::fclose(file);
+        return false;
+    }
+
+    log.path = path;
+    log.records.clear();
+
+    dlib::TelemetryRecord record;
+    // a log cut off by a power loss ends in a partial record, which is ignored
+    while (std::fread(&record, sizeof(record), 1, file) == 1) {
+        log.records.push_back(record);
+    }
+
+    std::fclose(file);
+    return true;
+}
+
+// split a log into motions, records outside of a motion are skipped
+inline std::vector<TelemetryMotionSpan> split_motions(const TelemetryLog& log) {
+    std::vector<TelemetryMotionSpan> spans;
+
+    for (size_t i = 0; i < log.records.size(); i++) {
+        auto& record = log.records[i];
+        if (static_cast<dlib::TelemetryMotion>(record.kind) == dlib::TelemetryMotion::None) {
+            continue;
+        }
+
+        bool same_motion = !spans.empty()
+            && spans.back().end == i
+            && log.records[spans.back().begin].motion == record.motion;
+
+        if (same_motion) {
+            spans.back().end = i + 1;
+        } else {
+            spans.push_back({i, i + 1});
+        }
+    }
+
+    return spans;
+}